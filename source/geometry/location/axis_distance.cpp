@@ -7,22 +7,34 @@
 
 #include "axis_distance.h"
 
+#include <algorithm>
+#include <cmath>
+
 AxisDistance::AxisDistance(const Facet& to)
     : boundingBox_(boundingBox(to))
     , origin_(to[0])
 {
-    // System for finding the coordinates over facetBasis
-    // of the ray-plane intersection point,
-    // see Möller-Trumbore intersection algorithm.
-    // Ray is collinear with the last axis.
-    Matrix A;
-    A.col(0) = Vector<>::Zero();
-    A(DIMS-1, 0) = -1.;
+    // Ray is collinear with the last axis, so the coordinates over
+    // facetBasis of the ray-plane intersection point only depend on
+    // the projections along it, see Möller-Trumbore intersection
+    // algorithm. Inverse of the small projected system is taken
+    // in closed form, so the setup costs no factorization.
+    Eigen::Matrix<double, DIMS, DIMS-1> edges;
     for (size_t i = 1; i < DIMS; ++i) {
-        A.col(i) = to[i] - origin_;
+        edges.col(i - 1) = to[i] - origin_;
+    }
+    const ProjectionMatrix projectedEdges = edges.topRows<DIMS-1>();
+    lastEdgeCoordinates_ = edges.row(DIMS-1).transpose();
+
+    // Projected volume is the facet one times the cosine between
+    // the facet normal and the last axis
+    const double projectedVolume = std::fabs(projectedEdges.determinant());
+    const double volume = std::sqrt(std::max(
+        (edges.transpose() * edges).determinant(), 0.));
+    vertical_ = !(projectedVolume > MEPS * volume);
+    if (!vertical_) {
+        inverseProjectedEdges_ = projectedEdges.inverse();
     }
-    solver_ = A.colPivHouseholderQr();
-    solver_.setThreshold(MEPS);
 }
 
 AxisDistance::Result AxisDistance::operator() (const Point& from) const
@@ -34,13 +46,15 @@ AxisDistance::Result AxisDistance::operator() (const Point& from) const
         }
     }
     // We skip vertical facets assuming closed polytopes
-    if (solver_.rank() < static_cast<int>(DIMS)) {
+    if (vertical_) {
         return {-1., Location::Outer};
     }
 
-    Vector<> solution = solver_.solve(from - origin_);
+    const Vector<> offset = from - origin_;
+    const ProjectionVector baseCoordinates =
+        inverseProjectedEdges_ * offset.head<DIMS-1>();
     return {
-        solution[0],
-        locationInFace(solution.data() + 1, DIMS - 1)
+        lastEdgeCoordinates_.dot(baseCoordinates) - offset[DIMS-1],
+        locationInFace(baseCoordinates.data(), DIMS - 1)
     };
 }
@@ -63,9 +63,14 @@ public:
     Result operator() (const Point& from) const;
 
 private:
-    using Matrix = Eigen::Matrix<double, DIMS, DIMS>;
+    using ProjectionMatrix = Eigen::Matrix<double, DIMS-1, DIMS-1>;
+    using ProjectionVector = Eigen::Matrix<double, DIMS-1, 1>;
 
     const BoundingBox boundingBox_;
     const Point origin_;
-    Eigen::ColPivHouseholderQR<Matrix> solver_;
+    // Facet basis coordinates of a point projection
+    // are the inverse projected edges applied to it
+    ProjectionMatrix inverseProjectedEdges_;
+    ProjectionVector lastEdgeCoordinates_;
+    bool vertical_;
 };
@@ -0,0 +1,114 @@
+// This file is part of xdscribe
+//
+// Copyright (C) 2019 Sergey Karpukhin <contact@kserz.rocks>
+//
+// Licensed under GNU General Public License version 3.
+// Full license text is available in LICENSE file.
+
+#pragma once
+
+#include "geometry/location/location.h"
+
+#include <cassert>
+#include <cstdint>
+#include <vector>
+
+static_assert(static_cast<int>(Location::Outer) == 0 &&
+        static_cast<int>(Location::Boundary) == 1 &&
+        static_cast<int>(Location::Inner) == 2,
+    "Locations are packed as their values");
+
+// Number of the set bits
+inline size_t bitCount(uint64_t word)
+{
+    word -= (word >> 1) & 0x5555555555555555;
+    word = (word & 0x3333333333333333) + ((word >> 2) & 0x3333333333333333);
+    word = (word + (word >> 4)) & 0x0f0f0f0f0f0f0f0f;
+    return static_cast<size_t>((word * 0x0101010101010101) >> 56);
+}
+
+// Sequence of locations taking 2 bits each, 32 per word,
+// so the sequences are counted and combined whole words at once
+class PackedLocations final {
+public:
+    static constexpr size_t PER_WORD = 32;
+    // Low bits of the locations in a word, the high ones follow them
+    static constexpr uint64_t LOW_BITS = 0x5555555555555555;
+
+    size_t size() const
+    {
+        return size_;
+    }
+    void clear()
+    {
+        words_.clear();
+        size_ = 0;
+    }
+    void reserve(size_t size)
+    {
+        words_.reserve((size + PER_WORD - 1) / PER_WORD);
+    }
+    void push_back(Location location)
+    {
+        if (size_ % PER_WORD == 0) {
+            words_.push_back(0);
+        }
+        words_.back() |=
+            static_cast<uint64_t>(location) << (size_ % PER_WORD * 2);
+        ++size_;
+    }
+
+    Location operator[](size_t index) const
+    {
+        assert(index < size_);
+        return static_cast<Location>(
+            (words_[index / PER_WORD] >> (index % PER_WORD * 2)) & 3);
+    }
+
+    size_t count(Location location) const
+    {
+        // Every location in a word equal to the one given
+        const uint64_t pattern = LOW_BITS * static_cast<uint64_t>(location);
+        size_t result = 0;
+        for (size_t i = 0; i < words_.size(); ++i) {
+            const uint64_t difference = words_[i] ^ pattern;
+            uint64_t matches = ~(difference | (difference >> 1)) & LOW_BITS;
+            if (i + 1 == words_.size()) {
+                matches &= usedBits();
+            }
+            result += bitCount(matches);
+        }
+        return result;
+    }
+
+    // Locations combined as transform(lhsWord, rhsWord) word by word,
+    // the sequences are to be of the same size
+    template<class Transform>
+    static void transform(
+            const PackedLocations& lhs,
+            const PackedLocations& rhs,
+            const Transform& transform,
+            PackedLocations* result)
+    {
+        assert(lhs.size_ == rhs.size_);
+        result->words_.resize(lhs.words_.size());
+        result->size_ = lhs.size_;
+        for (size_t i = 0; i < lhs.words_.size(); ++i) {
+            result->words_[i] = transform(lhs.words_[i], rhs.words_[i]);
+        }
+        if (!result->words_.empty()) {
+            result->words_.back() &= result->usedBits();
+        }
+    }
+
+private:
+    // Bits of the last word taken by the locations
+    uint64_t usedBits() const
+    {
+        const size_t used = size_ % PER_WORD;
+        return used == 0 ? ~uint64_t{0} : (uint64_t{1} << (used * 2)) - 1;
+    }
+
+    std::vector<uint64_t> words_;
+    size_t size_ = 0;
+};
@@ -9,7 +9,6 @@
 
 #include "geometry/entity/bounding_box.h"
 #include "grid/rasterization/facet_box_overlap.h"
-#include "grid/sampling/xd_iterator.h"
 
 FacetRasterizer bBoxFacetRasterizer(double coarseThreshold)
 {
@@ -19,15 +18,11 @@ FacetRasterizer bBoxFacetRasterizer(double coarseThreshold)
         const auto facetBBox = boundingBox(localFacet);
         const auto min = intFloor(facetBBox.min());
         const auto max = intFloor(facetBBox.max());
-        const auto size = (max - min + Coordinates::constant(1)).eval();
 
         // Small facet => coarse rasterization
         if ((facetBBox.max() - facetBBox.min()).maxCoeff() < coarseThreshold) {
-            XDIterator<DIMS>::run(size, [&] (const Coordinates& offset) {
-                auto* it = raster->find((min + offset).eval());
-                if (it) {
-                    it->value = Location::Boundary;
-                }
+            raster->boxSlice(min, max).process([] (Voxel<Location>& voxel) {
+                voxel.value = Location::Boundary;
             });
             return;
         }
@@ -37,14 +32,7 @@ FacetRasterizer bBoxFacetRasterizer(double coarseThreshold)
             Vector<>::Constant(1.),
             localFacet);
 
-        raster->voxels().process([&] (Voxel<Location>& voxel) {
-            for (size_t i = 0; i < DIMS; ++i) {
-                if (voxel.coordinates()[i] < min[i] ||
-                        voxel.coordinates()[i] > max[i]) {
-                    return;
-                }
-            }
-
+        raster->boxSlice(min, max).process([&] (Voxel<Location>& voxel) {
             if (voxelOverlap(voxel.coordinates().cast<double>().eval())) {
                 voxel.value = Location::Boundary;
             }
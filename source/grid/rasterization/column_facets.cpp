@@ -0,0 +1,95 @@
+// This file is part of xdscribe
+//
+// Copyright (C) 2019 Sergey Karpukhin <contact@kserz.rocks>
+//
+// Licensed under GNU General Public License version 3.
+// Full license text is available in LICENSE file.
+
+#include "column_facets.h"
+
+#include "geometry/entity/bounding_box.h"
+#include "grid/sampling/xd_iterator.h"
+
+#include <algorithm>
+#include <cassert>
+#include <utility>
+
+ColumnFacets::ColumnFacets(
+        const Generator<const Facet&>& localPolytopeGeometry,
+        Coordinates min,
+        Coordinates max)
+    : min_(std::move(min))
+    , max_(std::move(max))
+{
+    size_t columnsCount = 1;
+    for (size_t i = 0; i < DIMS-1; ++i) {
+        size_[i] = std::max(max_[i] - min_[i] + 1, 0);
+        columnsCount *= static_cast<size_t>(size_[i]);
+    }
+    size_[DIMS-1] = 1;
+
+    // Footprints are the column boxes touched, stored as the lower
+    // corner and the size, empty ones are skipped
+    std::vector<std::pair<Coordinates, Coordinates>> footprints;
+    offsets_.assign(columnsCount + 1, 0);
+    localPolytopeGeometry.process([&] (const Facet& facet) {
+        const BoundingBox facetBBox = boundingBox(facet);
+        // Same bounds as for overlappingVoxels()
+        const Coordinates footprintMin =
+            (intFloor(facetBBox.min()) - Coordinates::constant(1))
+                .cwiseMax(min_).eval();
+        const Coordinates footprintMax =
+            intFloor(facetBBox.max()).cwiseMin(max_).eval();
+
+        Coordinates footprintSize;
+        footprintSize[DIMS-1] = 1;
+        for (size_t i = 0; i < DIMS-1; ++i) {
+            footprintSize[i] = footprintMax[i] - footprintMin[i] + 1;
+            if (footprintSize[i] <= 0) {
+                return;
+            }
+        }
+
+        facets_.push_back(facet);
+        footprints.emplace_back(footprintMin, footprintSize);
+        XDIterator<DIMS-1>::run(footprintSize, [&] (const auto& offset) {
+            ++offsets_[columnIndex((footprintMin + offset).eval()) + 1];
+        });
+    });
+
+    for (size_t i = 0; i < columnsCount; ++i) {
+        offsets_[i + 1] += offsets_[i];
+    }
+
+    // Facets are put in order, so every column is sorted
+    auto fillPositions = offsets_;
+    indices_.resize(offsets_.back());
+    for (size_t j = 0; j < footprints.size(); ++j) {
+        const auto& [footprintMin, footprintSize] = footprints[j];
+        XDIterator<DIMS-1>::run(footprintSize, [&] (const auto& offset) {
+            indices_[fillPositions[columnIndex(
+                (footprintMin + offset).eval())]++] = j;
+        });
+    }
+}
+
+Generator<const Facet&> ColumnFacets::columnGeometry(
+        const Coordinates& coordinates) const
+{
+    return Generator<const Facet&>([this, coordinates] (auto&& yield) {
+        for (auto it = begin(coordinates); it != end(coordinates); ++it) {
+            yield(facets_[*it]);
+        }
+    });
+}
+
+size_t ColumnFacets::columnIndex(const Coordinates& coordinates) const
+{
+    size_t result = 0;
+    for (size_t i = 0; i < DIMS-1; ++i) {
+        assert(coordinates[i] >= min_[i] && coordinates[i] <= max_[i]);
+        result = result * static_cast<size_t>(size_[i]) +
+            static_cast<size_t>(coordinates[i] - min_[i]);
+    }
+    return result;
+}
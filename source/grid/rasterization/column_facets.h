@@ -0,0 +1,57 @@
+// This file is part of xdscribe
+//
+// Copyright (C) 2019 Sergey Karpukhin <contact@kserz.rocks>
+//
+// Licensed under GNU General Public License version 3.
+// Full license text is available in LICENSE file.
+
+#pragma once
+
+#include "geometry/kernel.h"
+#include "utility/generator.h"
+
+#include <vector>
+
+// Facets of the local geometry bucketed by the raster columns along
+// the last axis within a box, bounds are included. A column keeps
+// every facet whose bounding box projection touches it, so a ray
+// along the last axis through the column misses all the others.
+class ColumnFacets final {
+public:
+    // Only the first DIMS-1 coordinates of the bounds are used
+    ColumnFacets(
+        const Generator<const Facet&>& localPolytopeGeometry,
+        Coordinates min,
+        Coordinates max);
+
+    // In the order of the geometry
+    const std::vector<Facet>& facets() const
+    {
+        return facets_;
+    }
+
+    // Ascending indices of the facets of the column the voxel is in.
+    // The last coordinate is ignored, the others are to be within the box.
+    const size_t* begin(const Coordinates& coordinates) const
+    {
+        return indices_.data() + offsets_[columnIndex(coordinates)];
+    }
+    const size_t* end(const Coordinates& coordinates) const
+    {
+        return indices_.data() + offsets_[columnIndex(coordinates) + 1];
+    }
+
+    // Facets of the column the voxel is in, see begin()
+    Generator<const Facet&> columnGeometry(
+        const Coordinates& coordinates) const;
+
+private:
+    size_t columnIndex(const Coordinates& coordinates) const;
+
+    const Coordinates min_;
+    const Coordinates max_;
+    Coordinates size_;
+    std::vector<Facet> facets_;
+    std::vector<size_t> offsets_;
+    std::vector<size_t> indices_;
+};
@@ -26,11 +26,21 @@ Vector<> evalEdgeNormal(
         facet[edge],
         facet[edge + 1 < DIMS ? edge + 1 : 0]
     };
-    const std::array<Point, 2> axisPoints {
-        Point::constant(0.),
-        Vector<>::Unit(axis).eval()
-    };
-    auto result = commonPerpendicular(edgePoints, axisPoints);
+
+    // Same perpendicular as the kernel one scaled to the unit
+    // largest coordinate, but with no factorization
+    Vector<> result =
+        (edgePoints[1] - edgePoints[0]).cross(Vector<>::Unit(axis));
+    const double largestCoordinate = result.cwiseAbs().maxCoeff();
+    if (largestCoordinate > MEPS) {
+        result /= largestCoordinate;
+    } else {
+        const std::array<Point, 2> axisPoints {
+            Point::constant(0.),
+            Vector<>::Unit(axis).eval()
+        };
+        result = commonPerpendicular(edgePoints, axisPoints);
+    }
 
     auto oppositeVertexIndex = edge == 0 ? DIMS - 1 : edge - 1;
     if (result.dot(facet[oppositeVertexIndex] - facet[edge]) > 0.) {
@@ -60,7 +70,11 @@ FacetBoxOverlap::FacetBoxOverlap(Vector<> boxSize, Facet facet)
     , facet_(std::move(facet))
     , facetBoundingBox_(boundingBox(facet_))
     , lazyFacetNormal_([this] {
-        return unitNormal(facet_);
+        assert(DIMS == 3);
+        const Vector<> normal =
+            (facet_[1] - facet_[0]).cross(facet_[2] - facet_[0]);
+        const double length = normal.norm();
+        return length > MEPS ? (normal / length).eval() : unitNormal(facet_);
     })
     , lazyPlaneTests_([this] {
         return buildPlaneTests(facet_, lazyFacetNormal_, boxSize_);
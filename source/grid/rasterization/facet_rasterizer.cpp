@@ -7,7 +7,13 @@
 
 #include "facet_rasterizer.h"
 
+#include "geometry/entity/bounding_box.h"
+#include "geometry/entity/perpendicular.h"
 #include "grid/rasterization/facet_box_overlap.h"
+#include "grid/sampling/xd_iterator.h"
+
+#include <algorithm>
+#include <cmath>
 
 void rasterizeFacetByOverlap(
         const Facet& localFacet,
@@ -17,9 +23,103 @@ void rasterizeFacetByOverlap(
             Vector<>::Constant(1.),
             localFacet);
 
-        raster->voxels().process([&] (Voxel<Location>& voxel) {
+        overlappingVoxels(raster, boundingBox(localFacet)).process(
+                [&] (Voxel<Location>& voxel) {
             if (voxelOverlap(voxel.coordinates().cast<double>().eval())) {
                 voxel.value = Location::Boundary;
             }
         });
 }
+
+Generator<const Coordinates&> facetPlaneVoxels(const Facet& localFacet)
+{
+    return Generator<const Coordinates&>([localFacet] (auto&& yield) {
+        const auto facetBBox = boundingBox(localFacet);
+        // Same bounds as for overlappingVoxels()
+        const Coordinates min =
+            (intFloor(facetBBox.min()) - Coordinates::constant(1)).eval();
+        const Coordinates max = intFloor(facetBBox.max());
+
+        const auto normal = unitNormal(localFacet);
+        size_t scanAxis = 0;
+        for (size_t i = 1; i < DIMS; ++i) {
+            if (std::fabs(normal[i]) > std::fabs(normal[scanAxis])) {
+                scanAxis = i;
+            }
+        }
+        if (!(std::fabs(normal[scanAxis]) > MEPS)) {
+            // Degenerate facet, no plane to follow
+            XDIterator<DIMS>::run(
+                    (max - min + Coordinates::constant(1)).eval(),
+                    [&] (const Coordinates& offset) {
+                yield((min + offset).eval());
+            });
+            return;
+        }
+
+        // Other axes in order, the scan one goes last
+        std::array<size_t, DIMS> axes;
+        auto columnsSize = Coordinates::constant(1);
+        for (size_t i = 0, j = 0; i < DIMS; ++i) {
+            if (i != scanAxis) {
+                axes[j] = i;
+                columnsSize[j] = max[i] - min[i] + 1;
+                ++j;
+            }
+        }
+        axes[DIMS-1] = scanAxis;
+
+        // Facet plane is normal.dot(point) == planeOffset
+        const double planeOffset = normal.dot(localFacet[0]);
+        XDIterator<DIMS-1>::run(columnsSize, [&] (const Coordinates& offset) {
+            auto coordinates = min;
+            // Plane is linear over the column cell, so it is bounded
+            // by the values at the cell corners
+            double scanMin = planeOffset;
+            double scanMax = planeOffset;
+            for (size_t j = 0; j < DIMS-1; ++j) {
+                const size_t axis = axes[j];
+                coordinates[axis] += offset[j];
+
+                const double lower = normal[axis] * coordinates[axis];
+                const double upper = lower + normal[axis];
+                scanMin -= std::max(lower, upper);
+                scanMax -= std::min(lower, upper);
+            }
+            scanMin /= normal[scanAxis];
+            scanMax /= normal[scanAxis];
+            if (scanMin > scanMax) {
+                std::swap(scanMin, scanMax);
+            }
+
+            const int scanBegin =
+                std::max(intFloor(scanMin) - 1, min[scanAxis]);
+            const int scanEnd = std::min(intFloor(scanMax), max[scanAxis]);
+            for (int i = scanBegin; i <= scanEnd; ++i) {
+                coordinates[scanAxis] = i;
+                yield(coordinates);
+            }
+        });
+    });
+}
+
+void rasterizeFacetByScanning(
+        const Facet& localFacet,
+        SparseRaster<Location>* raster)
+{
+    if (!(unitNormal(localFacet).cwiseAbs().maxCoeff() > MEPS)) {
+        // Degenerate facet, the whole bounding box is to be tested
+        rasterizeFacetByOverlap(localFacet, raster);
+        return;
+    }
+
+    FacetBoxOverlap voxelOverlap(
+        Vector<>::Constant(1.),
+        localFacet);
+    facetPlaneVoxels(localFacet).process([&] (const Coordinates& coordinates) {
+        auto* voxel = raster->find(coordinates);
+        if (voxel && voxelOverlap(coordinates.cast<double>().eval())) {
+            voxel->value = Location::Boundary;
+        }
+    });
+}
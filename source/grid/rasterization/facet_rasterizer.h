@@ -10,6 +10,7 @@
 #include "geometry/kernel.h"
 #include "geometry/location/location.h"
 #include "grid/sampling/sparse_raster.h"
+#include "utility/generator.h"
 
 #include <functional>
 
@@ -21,3 +22,17 @@ using FacetRasterizer = std::function<void(
 void rasterizeFacetByOverlap(
         const Facet& localFacet,
         SparseRaster<Location>* raster);
+
+// Voxels of the facet bounding box near its plane, a superset of the ones
+// overlapping the facet. Those are found column by column along the axis
+// the facet is the least inclined to, so there are about as many of them
+// as of the voxels the facet projection covers. The whole bounding box
+// is generated for a degenerate facet.
+Generator<const Coordinates&> facetPlaneVoxels(const Facet& localFacet);
+
+// Same image as by overlap, but only the facet plane voxels are tested,
+// so a facet costs in proportion to its projection area rather than
+// its bounding box volume.
+void rasterizeFacetByScanning(
+        const Facet& localFacet,
+        SparseRaster<Location>* raster);
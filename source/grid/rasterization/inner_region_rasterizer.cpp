@@ -8,8 +8,15 @@
 #include "inner_region_rasterizer.h"
 
 #include "geometry/location/axis_distance.h"
+#include "grid/rasterization/column_facets.h"
 #include "grid/sampling/vector_sparse_raster.h"
 
+#include <algorithm>
+#include <cassert>
+#include <deque>
+#include <limits>
+#include <optional>
+#include <utility>
 #include <vector>
 
 namespace {
@@ -20,54 +27,179 @@ inline Point voxelCenter(const Coordinates& coordinates)
     return (coordinates.cast<double>() + voxelCenterOffset).eval();
 }
 
-VectorSparseRaster<std::vector<AxisDistance::Result>> sortedDistancesAbove(
+Generator<const Coordinates&> outerVoxels(const SparseRaster<Location>& raster)
+{
+    return compositeGenerator<const Coordinates&>(
+        raster.voxels(),
+        [] (const auto& voxel, auto&& yield) {
+            if (voxel.value == Location::Outer) {
+                yield(voxel.coordinates());
+            }
+        });
+}
+
+// Distances from the nodes to the geometry above them along the last axis.
+// Those of a node are sorted, unique and stored in a row of a single buffer.
+struct DistancesAbove final {
+    size_t size() const
+    {
+        return nodes.size();
+    }
+
+    using Iterator = std::vector<AxisDistance::Result>::const_iterator;
+    Iterator begin(size_t nodeIndex) const
+    {
+        return distances.begin() + offsets[nodeIndex];
+    }
+    Iterator end(size_t nodeIndex) const
+    {
+        return distances.begin() + offsets[nodeIndex + 1];
+    }
+
+    // In the raster order
+    std::vector<Coordinates> nodes;
+    std::vector<size_t> offsets;
+    std::vector<AxisDistance::Result> distances;
+};
+
+// Facets of the columns the nodes are in, nothing if there are no nodes
+std::optional<ColumnFacets> nodeColumnFacets(
+        const Generator<const Coordinates&>& nodes,
+        const Generator<const Facet&>& localPolytopeGeometry)
+{
+    auto min = Coordinates::constant(std::numeric_limits<int>::max());
+    auto max = Coordinates::constant(std::numeric_limits<int>::min());
+    bool empty = true;
+    nodes.process([&] (const Coordinates& coordinates) {
+        min = min.cwiseMin(coordinates).eval();
+        max = max.cwiseMax(coordinates).eval();
+        empty = false;
+    });
+
+    if (empty) {
+        return std::nullopt;
+    }
+    return std::make_optional<ColumnFacets>(
+        localPolytopeGeometry, std::move(min), std::move(max));
+}
+
+// Selection is to be in the raster order without duplicates
+DistancesAbove sortedDistancesAbove(
         const Generator<const Coordinates&>& selection,
         size_t estimatedCapacity,
         const Generator<const Facet&>& localPolytopeGeometry)
 {
-    VectorSparseRaster<std::vector<AxisDistance::Result>> result(
-        selection, {}, estimatedCapacity);
-
-    localPolytopeGeometry.process([&] (const auto& facet) {
-        AxisDistance facetDistance(facet);
-
-        result.voxels().process([&] (auto& voxel) {
-            auto testPoint = voxelCenter(voxel.coordinates());
-            auto distance = facetDistance(testPoint);
-
-            // Solve the cases where the geometry
-            // merely touches the vertical ray
-            // and the test point is still outside
-            size_t offsetCoordinateIndex = 0;
-            while (distance.location() == Location::Boundary &&
-                    offsetCoordinateIndex < DIMS) {
-                testPoint[offsetCoordinateIndex] += 2. * MEPS;
-                distance = facetDistance(testPoint);
-                ++offsetCoordinateIndex;
-            }
+    DistancesAbove result;
+    result.nodes.reserve(estimatedCapacity);
+    selection.process([&] (const Coordinates& coordinates) {
+        assert(result.nodes.empty() ||
+            preceding(result.nodes.back(), coordinates));
+        result.nodes.push_back(coordinates);
+    });
+
+    result.offsets.reserve(result.size() + 1);
+    result.offsets.push_back(0);
+    const auto columns = nodeColumnFacets(
+        Generator<const Coordinates&>{&result.nodes}, localPolytopeGeometry);
+    if (!columns) {
+        return result;
+    }
+
+    // Distances are not movable, deque keeps them in place
+    std::deque<AxisDistance> facetDistances;
+    for (const auto& facet : columns->facets()) {
+        facetDistances.emplace_back(facet);
+    }
 
+    auto& distances = result.distances;
+    for (const auto& node : result.nodes) {
+        const size_t rowBegin = distances.size();
+        for (auto facetIndex = columns->begin(node);
+                facetIndex != columns->end(node); ++facetIndex) {
+            const auto distance =
+                voxelDistanceAbove(facetDistances[*facetIndex], node);
             if (distance && distance.value() > -MEPS) {
-                voxel.value.push_back(distance);
+                distances.push_back(distance);
             }
-        });
-    });
+        }
 
-    result.voxels().process([] (auto& voxel) {
-        auto& value = voxel.value;
-        std::sort(value.begin(), value.end());
-        auto last = std::unique(value.begin(), value.end());
-        value.erase(last, value.end());
-    });
+        const auto begin = distances.begin() + rowBegin;
+        std::sort(begin, distances.end());
+        distances.erase(std::unique(begin, distances.end()), distances.end());
+        result.offsets.push_back(distances.size());
+    }
 
     return result;
 }
 
+// Union-find over the indices with path halving
+class DisjointSets final {
+public:
+    explicit DisjointSets(size_t size)
+        : parents_(size)
+    {
+        for (size_t i = 0; i < size; ++i) {
+            parents_[i] = i;
+        }
+    }
+
+    size_t find(size_t index)
+    {
+        while (parents_[index] != index) {
+            parents_[index] = parents_[parents_[index]];
+            index = parents_[index];
+        }
+        return index;
+    }
+
+    // The smaller root is kept, so a set is represented by its least index
+    void unite(size_t lhs, size_t rhs)
+    {
+        lhs = find(lhs);
+        rhs = find(rhs);
+        if (lhs < rhs) {
+            parents_[rhs] = lhs;
+        } else {
+            parents_[lhs] = rhs;
+        }
+    }
+
+private:
+    std::vector<size_t> parents_;
+};
+
 } // namespace
 
+AxisDistance::Result voxelDistanceAbove(
+        const AxisDistance& facetDistance,
+        const Coordinates& voxel)
+{
+    auto testPoint = voxelCenter(voxel);
+    auto distance = facetDistance(testPoint);
+
+    // Solve the cases where the geometry
+    // merely touches the vertical ray
+    // and the test point is still outside
+    size_t offsetCoordinateIndex = 0;
+    while (distance.location() == Location::Boundary &&
+            offsetCoordinateIndex < DIMS) {
+        testPoint[offsetCoordinateIndex] += 2. * MEPS;
+        distance = facetDistance(testPoint);
+        ++offsetCoordinateIndex;
+    }
+    return distance;
+}
+
 void rasterizeInnerRegionSequentally(
         const Generator<const Facet&>& localPolytopeGeometry,
         SparseRaster<Location>* raster)
 {
+    const auto columns = nodeColumnFacets(
+        outerVoxels(*raster), localPolytopeGeometry);
+    if (!columns) {
+        return;
+    }
+
     raster->voxels().process([&] (auto& voxel) {
         if (voxel.value != Location::Outer) {
             return;
@@ -75,7 +207,7 @@ void rasterizeInnerRegionSequentally(
 
         voxel.value = locatePoint(
             voxelCenter(voxel.coordinates()),
-            localPolytopeGeometry);
+            columns->columnGeometry(voxel.coordinates()));
     });
 }
 
@@ -84,81 +216,155 @@ void rasterizeInnerRegionByFacets(
         SparseRaster<Location>* raster)
 {
     const auto distancesAbove = sortedDistancesAbove(
-        compositeGenerator<const Coordinates&>(
-            raster->voxels(),
-            [] (const auto& voxel, auto&& yield) {
-                if (voxel.value == Location::Outer) {
-                    yield(voxel.coordinates());
-                }
-            }),
+        outerVoxels(*raster),
         raster->size(),
         localPolytopeGeometry);
 
     // Iterate over outer nodes only
-    distancesAbove.voxels().process([&] (const auto& distancesVoxel) {
-        const auto& nodeDistancesAbove = distancesVoxel.value;
-        auto* targetVoxel = raster->find(distancesVoxel.coordinates());
+    for (size_t i = 0; i < distancesAbove.size(); ++i) {
+        const auto nodeDistancesAbove = distancesAbove.begin(i);
+        const bool nodeDistancesEmpty =
+            nodeDistancesAbove == distancesAbove.end(i);
+        auto* targetVoxel = raster->find(distancesAbove.nodes[i]);
         assert(targetVoxel);
         auto& targetVoxelValue = targetVoxel->value;
 
-        if (!nodeDistancesAbove.empty() &&
-                nodeDistancesAbove.begin()->value() < MEPS) {
+        if (!nodeDistancesEmpty && nodeDistancesAbove->value() < MEPS) {
             targetVoxelValue = Location::Boundary;
-        } else if (nodeDistancesAbove.size() % 2 != 0){
+        } else if ((distancesAbove.end(i) - nodeDistancesAbove) % 2 != 0) {
             targetVoxelValue = Location::Inner;
         }
-    });
+    }
 }
 
 void rasterizeInnerRegionByRays(
         const Generator<const Facet&>& localPolytopeGeometry,
         SparseRaster<Location>* raster)
 {
-     const auto distancesAbove = sortedDistancesAbove(
+    // Voxels of a column come in a row, so are their projections
+    std::optional<Coordinates> lastProjection;
+    const auto distancesAbove = sortedDistancesAbove(
         compositeGenerator<const Coordinates&>(
             raster->voxels(),
-            [] (const auto& voxel, auto&& yield) {
+            [&] (const auto& voxel, auto&& yield) {
                 if (voxel.value == Location::Outer) {
                     // Projection on 0-plane
                     auto coordinates = voxel.coordinates();
                     coordinates[DIMS-1] = 0;
-                    yield(coordinates);
+                    if (lastProjection != coordinates) {
+                        lastProjection = coordinates;
+                        yield(coordinates);
+                    }
                 }
             }),
         raster->size(),
         localPolytopeGeometry);
 
-    distancesAbove.voxels().process([&] (auto& distancesVoxel) {
-        const auto& nodeDistancesAbove = distancesVoxel.value;
-        auto currentDistanceAbove = nodeDistancesAbove.begin();
-        size_t intersectionsLeftAbove = nodeDistancesAbove.size();
-        assert (distancesVoxel.coordinates()[DIMS-1] == 0);
+    // Columns are contiguous runs of the raster order, so the voxels
+    // are swept once along with the column distances
+    size_t column = 0;
+    bool columnStarted = false;
+    DistancesAbove::Iterator currentDistanceAbove;
+    DistancesAbove::Iterator columnEnd;
+    size_t intersectionsLeftAbove = 0;
+    raster->voxels().process([&] (auto& samplingVoxel) {
+        if (samplingVoxel.value != Location::Outer) {
+            return;
+        }
 
-        raster->verticalSlice(distancesVoxel.coordinates()).process(
-                [&] (auto& samplingVoxel) {
-            if (samplingVoxel.value != Location::Outer) {
-                return;
+        auto projection = samplingVoxel.coordinates();
+        projection[DIMS-1] = 0;
+        if (!columnStarted ||
+                distancesAbove.nodes[column - 1] != projection) {
+            while (preceding(distancesAbove.nodes[column], projection)) {
+                ++column;
             }
+            assert(distancesAbove.nodes[column] == projection);
+            currentDistanceAbove = distancesAbove.begin(column);
+            columnEnd = distancesAbove.end(column);
+            intersectionsLeftAbove = columnEnd - currentDistanceAbove;
+            columnStarted = true;
+            ++column;
+        }
 
-            auto currentBound = static_cast<double>(
-                samplingVoxel.coordinates()[DIMS-1]);
+        auto currentBound = static_cast<double>(
+            samplingVoxel.coordinates()[DIMS-1]);
 
-            while(currentDistanceAbove != nodeDistancesAbove.end() &&
-                   currentDistanceAbove->value() < currentBound - MEPS) {
-                ++currentDistanceAbove;
-                assert(intersectionsLeftAbove > 0);
-                --intersectionsLeftAbove;
-            }
+        while(currentDistanceAbove != columnEnd &&
+               currentDistanceAbove->value() < currentBound - MEPS) {
+            ++currentDistanceAbove;
+            assert(intersectionsLeftAbove > 0);
+            --intersectionsLeftAbove;
+        }
 
-            if (currentDistanceAbove == nodeDistancesAbove.end()) {
-                return;
-            }
+        if (currentDistanceAbove == columnEnd) {
+            return;
+        }
 
-            if (currentDistanceAbove->value() < currentBound + MEPS) {
-                samplingVoxel.value = Location::Boundary;
-            } else if (intersectionsLeftAbove % 2 == 1) {
-                samplingVoxel.value = Location::Inner;
-            }
-        });
+        if (currentDistanceAbove->value() < currentBound + MEPS) {
+            samplingVoxel.value = Location::Boundary;
+        } else if (intersectionsLeftAbove % 2 == 1) {
+            samplingVoxel.value = Location::Inner;
+        }
+    });
+}
+
+void rasterizeInnerRegionByComponents(
+        const Generator<const Facet&>& localPolytopeGeometry,
+        SparseRaster<Location>* raster)
+{
+    // Outer voxels are numbered in the raster order
+    std::vector<Coordinates> nodes;
+    outerVoxels(*raster).process([&] (const Coordinates& coordinates) {
+        assert(nodes.empty() || preceding(nodes.back(), coordinates));
+        nodes.push_back(coordinates);
+    });
+    const auto columns = nodeColumnFacets(
+        Generator<const Coordinates&>{&nodes}, localPolytopeGeometry);
+    if (!columns) {
+        return;
+    }
+
+    auto numbering = VectorSparseRaster<size_t>::fromSorted(nodes, 0);
+    size_t index = 0;
+    numbering.voxels().process([&] (Voxel<size_t>& voxel) {
+        voxel.value = index++;
+    });
+
+    DisjointSets components(nodes.size());
+    for (size_t axis = 0; axis < DIMS; ++axis) {
+        auto offset = Coordinates::constant(0);
+        offset[axis] = 1;
+        joinVoxels(
+            numbering.voxels(),
+            std::as_const(numbering).voxels(),
+            offset,
+            [&] (const Voxel<size_t>& voxel, const Voxel<size_t>* neighbour) {
+                if (neighbour) {
+                    components.unite(voxel.value, neighbour->value);
+                }
+            });
+    }
+
+    // Components are located by their first voxels,
+    // those located at the boundary leave every voxel on its own
+    std::vector<Location> componentLocations(nodes.size(), Location::Outer);
+    index = 0;
+    raster->voxels().process([&] (auto& voxel) {
+        if (voxel.value != Location::Outer) {
+            return;
+        }
+
+        const size_t component = components.find(index);
+        if (component == index ||
+                componentLocations[component] == Location::Boundary) {
+            componentLocations[index] = locatePoint(
+                voxelCenter(voxel.coordinates()),
+                columns->columnGeometry(voxel.coordinates()));
+            voxel.value = componentLocations[index];
+        } else {
+            voxel.value = componentLocations[component];
+        }
+        ++index;
     });
 }
@@ -7,6 +7,7 @@
 
 #pragma once
 
+#include "geometry/location/axis_distance.h"
 #include "geometry/location/location.h"
 #include "grid/sampling/sparse_raster.h"
 
@@ -19,6 +20,12 @@ using InnerRegionRasterizer = std::function<void(
     const Generator<const Facet&>& localPolytopeGeometry,
     SparseRaster<Location>* raster)>;
 
+// Distance from the voxel center to the facet along the last axis.
+// While the ray merely touches the facet the center is shifted a bit.
+AxisDistance::Result voxelDistanceAbove(
+        const AxisDistance& facetDistance,
+        const Coordinates& voxel);
+
 // Every facent and every node is processed independently
 void rasterizeInnerRegionSequentally(
         const Generator<const Facet&>& localPolytopeGeometry,
@@ -36,3 +43,12 @@ void rasterizeInnerRegionByFacets(
 void rasterizeInnerRegionByRays(
         const Generator<const Facet&>& localPolytopeGeometry,
         SparseRaster<Location>* raster);
+
+// Outer voxels connected through the faces share the location
+// unless a facet crosses the common face, and then both are drawn
+// as the boundary already. So every connected component of those
+// is located by a single voxel and the result is spread over it.
+// A component found at the boundary is located voxel by voxel.
+void rasterizeInnerRegionByComponents(
+        const Generator<const Facet&>& localPolytopeGeometry,
+        SparseRaster<Location>* raster);
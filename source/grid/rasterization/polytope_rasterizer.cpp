@@ -7,6 +7,16 @@
 
 #include "polytope_rasterizer.h"
 
+#include "geometry/location/axis_distance.h"
+#include "grid/rasterization/column_facets.h"
+#include "grid/rasterization/facet_box_overlap.h"
+
+#include <algorithm>
+#include <deque>
+#include <limits>
+#include <utility>
+#include <vector>
+
 PolytopeRasterizer polytopeRasterizer(
         FacetRasterizer facetRasterizer,
         InnerRegionRasterizer innerRegionRasterizer)
@@ -24,3 +34,113 @@ PolytopeRasterizer polytopeRasterizer(
             innerRegionRasterizer(localPolytopeGeometry, raster);
         };
 }
+
+void rasterizePolytopeByColumns(
+        const Generator<const Facet&>& localPolytopeGeometry,
+        SparseRaster<Location>* raster)
+{
+    auto min = Coordinates::constant(std::numeric_limits<int>::max());
+    auto max = Coordinates::constant(std::numeric_limits<int>::min());
+    std::as_const(*raster).voxels().process([&] (const auto& voxel) {
+        min = min.cwiseMin(voxel.coordinates()).eval();
+        max = max.cwiseMax(voxel.coordinates()).eval();
+    });
+    if ((min.array() > max.array()).any()) {
+        return;
+    }
+
+    const ColumnFacets columns(localPolytopeGeometry, min, max);
+    // Tests are not movable, deques keep them in place
+    std::deque<FacetBoxOverlap> facetOverlaps;
+    std::deque<AxisDistance> facetDistances;
+    for (const auto& facet : columns.facets()) {
+        facetOverlaps.emplace_back(Vector<>::Constant(1.), facet);
+        facetDistances.emplace_back(facet);
+    }
+
+    std::vector<Voxel<Location>*> column;
+    std::vector<AxisDistance::Result> distancesAbove;
+    const auto rasterizeColumn = [&] {
+        const auto projection = [&] {
+            auto result = column.front()->coordinates();
+            result[DIMS-1] = 0;
+            return result;
+        }();
+        const auto facetsBegin = columns.begin(projection);
+        const auto facetsEnd = columns.end(projection);
+
+        bool haveOuterVoxels = false;
+        for (auto* voxel : column) {
+            const Point corner = voxel->coordinates().cast<double>().eval();
+            for (auto facetIndex = facetsBegin;
+                    facetIndex != facetsEnd; ++facetIndex) {
+                if (facetOverlaps[*facetIndex](corner)) {
+                    voxel->value = Location::Boundary;
+                    break;
+                }
+            }
+            haveOuterVoxels = haveOuterVoxels ||
+                voxel->value == Location::Outer;
+        }
+        if (!haveOuterVoxels) {
+            return;
+        }
+
+        distancesAbove.clear();
+        for (auto facetIndex = facetsBegin;
+                facetIndex != facetsEnd; ++facetIndex) {
+            const auto distance =
+                voxelDistanceAbove(facetDistances[*facetIndex], projection);
+            if (distance && distance.value() > -MEPS) {
+                distancesAbove.push_back(distance);
+            }
+        }
+        std::sort(distancesAbove.begin(), distancesAbove.end());
+        distancesAbove.erase(
+            std::unique(distancesAbove.begin(), distancesAbove.end()),
+            distancesAbove.end());
+
+        // Voxels of a column are ordered along the last axis
+        auto currentDistanceAbove = distancesAbove.cbegin();
+        for (auto* voxel : column) {
+            if (voxel->value != Location::Outer) {
+                continue;
+            }
+
+            const auto currentBound =
+                static_cast<double>(voxel->coordinates()[DIMS-1]);
+            while (currentDistanceAbove != distancesAbove.cend() &&
+                    currentDistanceAbove->value() < currentBound - MEPS) {
+                ++currentDistanceAbove;
+            }
+            if (currentDistanceAbove == distancesAbove.cend()) {
+                break;
+            }
+
+            if (currentDistanceAbove->value() < currentBound + MEPS) {
+                voxel->value = Location::Boundary;
+            } else if (
+                    (distancesAbove.cend() - currentDistanceAbove) % 2 == 1) {
+                voxel->value = Location::Inner;
+            }
+        }
+    };
+
+    // Columns are contiguous runs of the raster order
+    raster->voxels().process([&] (Voxel<Location>& voxel) {
+        if (!column.empty()) {
+            const auto& columnStart = column.front()->coordinates();
+            for (size_t i = 0; i < DIMS-1; ++i) {
+                if (voxel.coordinates()[i] != columnStart[i]) {
+                    rasterizeColumn();
+                    column.clear();
+                    break;
+                }
+            }
+        }
+        column.push_back(&voxel);
+    });
+    if (!column.empty()) {
+        rasterizeColumn();
+    }
+}
@@ -24,3 +24,11 @@ using PolytopeRasterizer = std::function<void(
 PolytopeRasterizer polytopeRasterizer(
         FacetRasterizer facetRasterizer,
         InnerRegionRasterizer innerRegionRasterizer);
+
+// Draws the facets and the inner region in a single pass over the raster
+// columns along the last axis. Facets crossing a column are taken once
+// for both its boundary voxels and the parity of the rest. The image is
+// the one of rasterizeFacetByOverlap with rasterizeInnerRegionByRays.
+void rasterizePolytopeByColumns(
+        const Generator<const Facet&>& localPolytopeGeometry,
+        SparseRaster<Location>* raster);
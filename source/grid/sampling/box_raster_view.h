@@ -0,0 +1,109 @@
+// This file is part of xdscribe
+//
+// Copyright (C) 2019 Sergey Karpukhin <contact@kserz.rocks>
+//
+// Licensed under GNU General Public License version 3.
+// Full license text is available in LICENSE file.
+
+#pragma once
+
+#include "grid/sampling/sparse_raster.h"
+
+#include <algorithm>
+#include <optional>
+
+// Part of the parent raster inside an axis-aligned box, bounds are included.
+// Voxels and values are shared with the parent, nothing is copied.
+//
+// NB. The parent must not be restructured while the view exists.
+template<class Value>
+class BoxRasterView final : public SparseRaster<Value> {
+public:
+    using Voxel = typename SparseRaster<Value>::Voxel;
+
+    BoxRasterView(
+            SparseRaster<Value>* parent,
+            Coordinates min,
+            Coordinates max)
+        : parent_(parent)
+        , min_(std::move(min))
+        , max_(std::move(max))
+    {}
+
+    // Voxels intersecting a box given in raster coordinates,
+    // see overlappingVoxels()
+    BoxRasterView(SparseRaster<Value>* parent, const BoundingBox& box)
+        : BoxRasterView(
+            parent,
+            (intFloor(box.min()) - Coordinates::constant(1)).eval(),
+            intFloor(box.max()))
+    {}
+
+    // Box voxels are counted in a single pass on the first call only
+    virtual size_t size() const override
+    {
+        if (!size_) {
+            size_ = 0;
+            voxels().process([&] (const Voxel& /*voxel*/) {
+                ++*size_;
+            });
+        }
+        return *size_;
+    }
+
+    virtual Generator<Voxel&> voxels() override
+    {
+        return parent_->boxSlice(min_, max_);
+    }
+    virtual Generator<const Voxel&> voxels() const override
+    {
+        return Generator<const Voxel&>([this] (auto&& yield) {
+            parent_->boxSlice(min_, max_).process([&] (const Voxel& voxel) {
+                yield(voxel);
+            });
+        });
+    }
+
+    virtual Voxel* find(const Coordinates& coordinates) override
+    {
+        return contains(coordinates) ? parent_->find(coordinates) : nullptr;
+    }
+    virtual const Voxel* find(const Coordinates& coordinates) const override
+    {
+        return contains(coordinates) ? parent_->find(coordinates) : nullptr;
+    }
+
+    virtual Generator<Voxel&> verticalSlice(const Coordinates& start) override
+    {
+        auto min = start;
+        min[DIMS-1] = std::max(min[DIMS-1], min_[DIMS-1]);
+        auto max = start;
+        max[DIMS-1] = max_[DIMS-1];
+        return boxSlice(min, max);
+    }
+
+    virtual Generator<Voxel&> boxSlice(
+            const Coordinates& min,
+            const Coordinates& max) override
+    {
+        return parent_->boxSlice(
+            min.cwiseMax(min_).eval(),
+            max.cwiseMin(max_).eval());
+    }
+
+private:
+    bool contains(const Coordinates& coordinates) const
+    {
+        for (size_t i = 0; i < DIMS; ++i) {
+            if (coordinates[i] < min_[i] || coordinates[i] > max_[i]) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    SparseRaster<Value>* const parent_;
+    const Coordinates min_;
+    const Coordinates max_;
+    mutable std::optional<size_t> size_;
+};
@@ -0,0 +1,126 @@
+// This file is part of xdscribe
+//
+// Copyright (C) 2019 Sergey Karpukhin <contact@kserz.rocks>
+//
+// Licensed under GNU General Public License version 3.
+// Full license text is available in LICENSE file.
+
+#include "location_planes.h"
+
+#include <limits>
+
+namespace {
+
+const size_t WORD_BITS = 64;
+
+// Sparse voxel costs 16 bytes, that is as much as 64 dense ones
+// in two planes. The margin keeps the word scans short.
+const size_t DENSE_VOXELS_PER_SPARSE = 16;
+
+} // namespace
+
+LocationPlanes::LocationPlanes(Coordinates min, Coordinates max)
+{
+    reset(std::move(min), std::move(max));
+}
+
+void LocationPlanes::reset(Coordinates min, Coordinates max)
+{
+    min_ = std::move(min);
+    max_ = std::move(max);
+
+    size_t volume = 1;
+    for (size_t i = 0; i < DIMS; ++i) {
+        size_[i] = std::max(max_[i] - min_[i] + 1, 0);
+        volume *= static_cast<size_t>(size_[i]);
+    }
+    covered_.assign((volume + WORD_BITS - 1) / WORD_BITS, 0);
+    inner_.assign(covered_.size(), 0);
+}
+
+std::optional<std::pair<Coordinates, Coordinates>>
+LocationPlanes::preferableBox(const SparseRaster<Location>& raster)
+{
+    if (raster.size() == 0) {
+        return std::nullopt;
+    }
+
+    auto min = Coordinates::constant(std::numeric_limits<int>::max());
+    auto max = Coordinates::constant(std::numeric_limits<int>::min());
+    raster.voxels().process([&] (const auto& voxel) {
+        min = min.cwiseMin(voxel.coordinates()).eval();
+        max = max.cwiseMax(voxel.coordinates()).eval();
+    });
+
+    size_t volume = 1;
+    for (size_t i = 0; i < DIMS; ++i) {
+        volume *= static_cast<size_t>(max[i] - min[i]) + 1;
+    }
+    if (volume > raster.size() * DENSE_VOXELS_PER_SPARSE) {
+        return std::nullopt;
+    }
+    return std::make_pair(min, max);
+}
+
+Location LocationPlanes::location(const Coordinates& coordinates) const
+{
+    for (size_t i = 0; i < DIMS; ++i) {
+        if (coordinates[i] < min_[i] || coordinates[i] > max_[i]) {
+            return Location::Outer;
+        }
+    }
+
+    const size_t index = bitIndex(coordinates);
+    const uint64_t mask = uint64_t{1} << (index % WORD_BITS);
+    if (inner_[index / WORD_BITS] & mask) {
+        return Location::Inner;
+    }
+    return covered_[index / WORD_BITS] & mask ?
+        Location::Boundary : Location::Outer;
+}
+
+void LocationPlanes::assign(const SparseRaster<Location>& raster)
+{
+    raster.voxels().process([&] (const auto& voxel) {
+        for (size_t i = 0; i < DIMS; ++i) {
+            if (voxel.coordinates()[i] < min_[i] ||
+                    voxel.coordinates()[i] > max_[i]) {
+                return;
+            }
+        }
+
+        const size_t index = bitIndex(voxel.coordinates());
+        const uint64_t mask = uint64_t{1} << (index % WORD_BITS);
+        auto& covered = covered_[index / WORD_BITS];
+        auto& inner = inner_[index / WORD_BITS];
+
+        covered &= ~mask;
+        inner &= ~mask;
+        if (voxel.value != Location::Outer) {
+            covered |= mask;
+        }
+        if (voxel.value == Location::Inner) {
+            inner |= mask;
+        }
+    });
+}
+
+void LocationPlanes::unite(const LocationPlanes& other)
+{
+    assert(min_ == other.min_ && max_ == other.max_);
+    for (size_t i = 0; i < covered_.size(); ++i) {
+        covered_[i] |= other.covered_[i];
+        inner_[i] |= other.inner_[i];
+    }
+}
+
+size_t LocationPlanes::bitIndex(const Coordinates& coordinates) const
+{
+    size_t result = 0;
+    for (size_t i = 0; i < DIMS; ++i) {
+        assert(coordinates[i] >= min_[i] && coordinates[i] <= max_[i]);
+        result = result * static_cast<size_t>(size_[i]) +
+            static_cast<size_t>(coordinates[i] - min_[i]);
+    }
+    return result;
+}
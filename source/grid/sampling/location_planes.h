@@ -0,0 +1,71 @@
+// This file is part of xdscribe
+//
+// Copyright (C) 2019 Sergey Karpukhin <contact@kserz.rocks>
+//
+// Licensed under GNU General Public License version 3.
+// Full license text is available in LICENSE file.
+
+#pragma once
+
+#include "geometry/kernel.h"
+#include "geometry/location/location.h"
+#include "grid/sampling/sparse_raster.h"
+
+#include <cstdint>
+#include <optional>
+#include <utility>
+#include <vector>
+
+// Dense image of the locations within a box of the raster, bounds are
+// included. Locations are kept as two bit-planes with 64 voxels per word:
+// the voxels touched by the image and the inner ones. The voxels not set
+// and the ones beyond the box are outer.
+class LocationPlanes final {
+public:
+    LocationPlanes(Coordinates min, Coordinates max);
+
+    // Empty image of another box, the planes keep their storage
+    void reset(Coordinates min, Coordinates max);
+
+    // Bounds of the raster voxels if the dense image of those
+    // takes noticeably less memory than the raster, nothing otherwise
+    static std::optional<std::pair<Coordinates, Coordinates>> preferableBox(
+            const SparseRaster<Location>& raster);
+
+    const Coordinates& min() const
+    {
+        return min_;
+    }
+    const Coordinates& max() const
+    {
+        return max_;
+    }
+
+    Location location(const Coordinates& coordinates) const;
+    // Locations of the raster voxels beyond the box are dropped
+    void assign(const SparseRaster<Location>& raster);
+
+    // Location of a voxel in the union of the images, i.e. a voxel
+    // is outer if so are both and inner if either one is inner.
+    // The boxes are to be equal.
+    void unite(const LocationPlanes& other);
+
+    // Folds the image into the raster voxels by
+    // combine(Location* voxelValue, Location imageValue)
+    template<class Combine>
+    void commit(SparseRaster<Location>* raster, const Combine& combine) const
+    {
+        raster->boxSlice(min_, max_).process([&] (auto& voxel) {
+            combine(&voxel.value, location(voxel.coordinates()));
+        });
+    }
+
+private:
+    size_t bitIndex(const Coordinates& coordinates) const;
+
+    Coordinates min_;
+    Coordinates max_;
+    Coordinates size_;
+    std::vector<uint64_t> covered_;
+    std::vector<uint64_t> inner_;
+};
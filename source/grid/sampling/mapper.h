@@ -7,11 +7,16 @@
 
 #pragma once
 
+#include "geometry/entity/bounding_box.h"
 #include "geometry/entity/placement.h"
 #include "geometry/kernel.h"
 #include "helper/stats.h"
 #include "utility/generator.h"
 
+#include <algorithm>
+#include <cmath>
+#include <optional>
+
 // Transforms entities between global coordinates
 // and grid based (local) ones
 class Mapper {
@@ -71,6 +76,10 @@ public:
         }
         return result;
     }
+    BoundingBox toLocal(const BoundingBox& box) const
+    {
+        return {toLocal(box.min()), toLocal(box.max())};
+    }
     Generator<const Facet&> toLocal(Generator<const Facet&> geometry) const
     {
         return mapGenerator<const Facet&>(
@@ -108,3 +117,28 @@ protected:
     Point localCenter_;
     Coordinates rasterSize_;
 };
+
+// Offset transferring voxel coordinates from one grid to another one,
+// empty if the grids are not aligned
+inline std::optional<Coordinates> alignmentOffset(
+        const Mapper& from,
+        const Mapper& to)
+{
+    // Steps are compared relatively to keep fine and coarse grids alike
+    const double stepTolerance =
+        MEPS * std::max(from.gridStep(), to.gridStep());
+    if (std::fabs(from.gridStep() - to.gridStep()) > stepTolerance) {
+        return std::nullopt;
+    }
+
+    const auto offset = to.toLocal(from.toGlobal(Coordinates::constant(0)));
+    Coordinates result;
+    for (size_t i = 0; i < DIMS; ++i) {
+        result[i] = static_cast<int>(std::lround(offset[i]));
+        // Aligned grids differ by rounding errors only
+        if (std::fabs(offset[i] - result[i]) > 1e-3) {
+            return std::nullopt;
+        }
+    }
+    return result;
+}
@@ -0,0 +1,97 @@
+// This file is part of xdscribe
+//
+// Copyright (C) 2019 Sergey Karpukhin <contact@kserz.rocks>
+//
+// Licensed under GNU General Public License version 3.
+// Full license text is available in LICENSE file.
+
+#include "packed_location_image.h"
+
+#include <limits>
+
+namespace {
+
+const unsigned KEY_BITS = 64;
+
+// A key costs 64 bits per voxel, the plane a bit and the rank a bit
+// per box voxel. The margin keeps the plane scans short.
+const size_t DENSE_VOXELS_PER_KEY = 16;
+
+unsigned bitWidth(unsigned value)
+{
+    unsigned result = 0;
+    while (value > 0) {
+        ++result;
+        value >>= 1;
+    }
+    return result;
+}
+
+} // namespace
+
+PackedLocationImage::PackedLocationImage(const Sampling<Location>& sampling)
+    : Mapper(sampling)
+    , min_(Coordinates::constant(std::numeric_limits<int>::max()))
+    , max_(Coordinates::constant(std::numeric_limits<int>::min()))
+{
+    const size_t size = sampling.size();
+    sampling.voxels().process([&] (const auto& voxel) {
+        min_ = min_.cwiseMin(voxel.coordinates()).eval();
+        max_ = max_.cwiseMax(voxel.coordinates()).eval();
+    });
+
+    unsigned totalBits = 0;
+    const size_t maxVolume = size * DENSE_VOXELS_PER_KEY;
+    // Nothing once the box is too large for the plane
+    std::optional<size_t> volume;
+    if (size > 0) {
+        volume = 1;
+    }
+    for (size_t i = 0; i < DIMS; ++i) {
+        const auto extent = size > 0 ?
+            static_cast<unsigned>(max_[i] - min_[i]) : 0u;
+        keyBits_[i] = bitWidth(extent);
+        totalBits += keyBits_[i];
+        if (volume && size_t{extent} + 1 <= maxVolume / *volume) {
+            *volume *= size_t{extent} + 1;
+        } else {
+            volume.reset();
+        }
+    }
+
+    if (volume) {
+        layout_ = Layout::Dense;
+        selected_.resize((*volume + WORD_BITS - 1) / WORD_BITS, 0);
+    } else if (totalBits <= KEY_BITS) {
+        layout_ = Layout::Keys;
+        keys_.reserve(size);
+    } else {
+        layout_ = Layout::Coordinates;
+        coordinates_.reserve(size);
+    }
+
+    locations_.reserve(size);
+    sampling.voxels().process([&] (const auto& voxel) {
+        if (layout_ == Layout::Dense) {
+            const auto bit = *boxIndex(voxel.coordinates());
+            selected_[bit / WORD_BITS] |= uint64_t{1} << (bit % WORD_BITS);
+        } else if (layout_ == Layout::Keys) {
+            keys_.push_back(*key(voxel.coordinates()));
+            assert(keys_.size() < 2 ||
+                keys_[keys_.size() - 2] < keys_.back());
+        } else {
+            coordinates_.push_back(voxel.coordinates());
+        }
+        locations_.push_back(voxel.value);
+    });
+
+    if (layout_ == Layout::Dense) {
+        ranks_.reserve(selected_.size());
+        size_t rank = 0;
+        for (const auto word : selected_) {
+            ranks_.push_back(rank);
+            rank += bitCount(word);
+        }
+        assert(rank == size);
+    }
+}
@@ -0,0 +1,215 @@
+// This file is part of xdscribe
+//
+// Copyright (C) 2019 Sergey Karpukhin <contact@kserz.rocks>
+//
+// Licensed under GNU General Public License version 3.
+// Full license text is available in LICENSE file.
+
+#pragma once
+
+#include "geometry/kernel.h"
+#include "geometry/location/location.h"
+#include "geometry/location/packed_locations.h"
+#include "grid/sampling/mapper.h"
+#include "grid/sampling/sampling.h"
+#include "utility/generator.h"
+
+#include <array>
+#include <cstdint>
+#include <optional>
+#include <vector>
+
+// Read-only copy of a location sampling compact enough to be cached.
+// Locations take 2 bits each in the raster order. The selection is kept
+// by its occupancy of the voxels box: a sparse one as the coordinates
+// packed into keys relative to the lowest voxel, so a voxel costs a bit
+// more than 8 bytes instead of 16 of the vector raster; a dense one as
+// a bit-plane over the box, a couple of bits per box voxel.
+// Voxels are only read in the raster order, no references are handed out.
+class PackedLocationImage final : public Mapper {
+public:
+    explicit PackedLocationImage(const Sampling<Location>& sampling);
+
+    size_t size() const
+    {
+        return locations_.size();
+    }
+    bool dense() const
+    {
+        return layout_ == Layout::Dense;
+    }
+    // In the raster order of the voxels
+    const PackedLocations& locations() const
+    {
+        return locations_;
+    }
+
+    // Calls callback(coordinates, location) for the voxels
+    // in the raster order
+    template<class Callback>
+    void process(const Callback& callback) const
+    {
+        if (layout_ != Layout::Dense) {
+            for (size_t i = 0; i < size(); ++i) {
+                callback(coordinates(i), locations_[i]);
+            }
+            return;
+        }
+
+        size_t index = 0;
+        for (size_t i = 0; i < selected_.size(); ++i) {
+            for (auto word = selected_[i]; word != 0; word &= word - 1) {
+                const auto bit = i * WORD_BITS + lowestBit(word);
+                callback(boxCoordinates(bit), locations_[index++]);
+            }
+        }
+    }
+
+    // Calls join(voxel, location) for every voxel of the sequence,
+    // the location is the one of the image voxel at the coordinates
+    // shifted by the offset or nullptr if there is none.
+    // The sequence is to be in the raster order, see joinVoxels().
+    template<class Value, class Join>
+    void join(
+            const Generator<Value&>& voxels,
+            const Coordinates& offset,
+            const Join& join) const
+    {
+        size_t current = 0;
+        voxels.process([&] (Value& voxel) {
+            const auto found =
+                seek((voxel.coordinates() + offset).eval(), &current);
+            if (found) {
+                const auto value = locations_[current];
+                join(voxel, &value);
+            } else {
+                join(voxel, nullptr);
+            }
+        });
+    }
+
+private:
+    enum class Layout {
+        Keys,
+        // Keys do not fit 64 bits for extremely stretched boxes only,
+        // the coordinates are kept as they are then
+        Coordinates,
+        Dense
+    };
+
+    static constexpr size_t WORD_BITS = 64;
+
+    static size_t lowestBit(uint64_t word)
+    {
+        return bitCount((word & (~word + 1)) - 1);
+    }
+
+    // Sets the position to the target voxel if there is one,
+    // sparse layouts only move it forward
+    bool seek(const Coordinates& target, size_t* current) const
+    {
+        if (layout_ == Layout::Dense) {
+            const auto bit = boxIndex(target);
+            if (!bit) {
+                return false;
+            }
+            const auto word = selected_[*bit / WORD_BITS];
+            const auto shift = *bit % WORD_BITS;
+            if (!((word >> shift) & 1)) {
+                return false;
+            }
+            *current = ranks_[*bit / WORD_BITS] +
+                bitCount(word & ((uint64_t{1} << shift) - 1));
+            return true;
+        } else if (layout_ == Layout::Keys) {
+            const auto targetKey = key(target);
+            if (!targetKey) {
+                return false;
+            }
+            while (*current < size() && keys_[*current] < *targetKey) {
+                ++*current;
+            }
+            return *current < size() && keys_[*current] == *targetKey;
+        }
+
+        while (*current < size() &&
+                preceding(coordinates_[*current], target)) {
+            ++*current;
+        }
+        return *current < size() && coordinates_[*current] == target;
+    }
+
+    bool inBox(const Coordinates& coordinates) const
+    {
+        for (size_t i = 0; i < DIMS; ++i) {
+            if (coordinates[i] < min_[i] || coordinates[i] > max_[i]) {
+                return false;
+            }
+        }
+        return true;
+    }
+    // Nothing beyond the box of the voxels
+    std::optional<uint64_t> key(const Coordinates& coordinates) const
+    {
+        if (!inBox(coordinates)) {
+            return std::nullopt;
+        }
+        uint64_t result = 0;
+        for (size_t i = 0; i < DIMS; ++i) {
+            result = (result << keyBits_[i]) |
+                static_cast<uint64_t>(coordinates[i] - min_[i]);
+        }
+        return result;
+    }
+    std::optional<size_t> boxIndex(const Coordinates& coordinates) const
+    {
+        if (!inBox(coordinates)) {
+            return std::nullopt;
+        }
+        size_t result = 0;
+        for (size_t i = 0; i < DIMS; ++i) {
+            result = result * static_cast<size_t>(max_[i] - min_[i] + 1) +
+                static_cast<size_t>(coordinates[i] - min_[i]);
+        }
+        return result;
+    }
+    Coordinates boxCoordinates(size_t index) const
+    {
+        Coordinates result;
+        for (size_t i = DIMS; i-- > 0;) {
+            const auto size = static_cast<size_t>(max_[i] - min_[i] + 1);
+            result[i] = min_[i] + static_cast<int>(index % size);
+            index /= size;
+        }
+        return result;
+    }
+    // Sparse layouts only
+    Coordinates coordinates(size_t index) const
+    {
+        if (layout_ == Layout::Coordinates) {
+            return coordinates_[index];
+        }
+
+        auto key = keys_[index];
+        Coordinates result;
+        for (size_t i = DIMS; i-- > 0;) {
+            const uint64_t mask = (uint64_t{1} << keyBits_[i]) - 1;
+            result[i] = min_[i] + static_cast<int>(key & mask);
+            key >>= keyBits_[i];
+        }
+        return result;
+    }
+
+    Coordinates min_;
+    Coordinates max_;
+    Layout layout_ = Layout::Keys;
+    PackedLocations locations_;
+
+    std::array<unsigned, DIMS> keyBits_;
+    std::vector<uint64_t> keys_;
+    std::vector<Coordinates> coordinates_;
+
+    std::vector<uint64_t> selected_;
+    // Selected voxels before every word of the plane
+    std::vector<size_t> ranks_;
+};
@@ -0,0 +1,112 @@
+// This file is part of xdscribe
+//
+// Copyright (C) 2019 Sergey Karpukhin <contact@kserz.rocks>
+//
+// Licensed under GNU General Public License version 3.
+// Full license text is available in LICENSE file.
+
+#pragma once
+
+#include "grid/sampling/sparse_raster.h"
+#include "grid/sampling/vector_sparse_raster.h"
+#include "utility/noncopyable.h"
+
+#include <cstddef>
+#include <utility>
+#include <vector>
+
+// Spare voxel storages kept with their capacity for the rasters built
+// over and over again, e.g. the images of every solver iteration.
+// Once the pool holds the storages as large as the rasters in use,
+// building those allocates nothing.
+// The pool is not synchronized, every solver owns a pool of its own.
+template<class Value>
+class RasterPool final : public NonCopyable {
+public:
+    using Storage = std::vector<Voxel<Value>>;
+
+    // Empty storage of at least the capacity: the smallest spare one fitting,
+    // the largest one grown if none fits or a new one if there are none
+    Storage acquire(size_t capacity)
+    {
+        auto best = spare_.end();
+        for (auto it = spare_.begin(); it != spare_.end(); ++it) {
+            if (best == spare_.end()) {
+                best = it;
+                continue;
+            }
+
+            const bool fits = it->capacity() >= capacity;
+            const bool bestFits = best->capacity() >= capacity;
+            if (fits != bestFits ?
+                    fits :
+                    (fits ? it->capacity() < best->capacity() :
+                        it->capacity() > best->capacity())) {
+                best = it;
+            }
+        }
+
+        Storage result;
+        if (best != spare_.end()) {
+            std::swap(*best, spare_.back());
+            result = std::move(spare_.back());
+            spare_.pop_back();
+        }
+        result.reserve(capacity);
+        return result;
+    }
+
+    void recycle(Storage storage)
+    {
+        if (storage.capacity() == 0) {
+            return;
+        }
+        storage.clear();
+        spare_.push_back(std::move(storage));
+    }
+    void recycle(VectorSparseRaster<Value>* raster)
+    {
+        recycle(raster->releaseStorage());
+    }
+
+    size_t spareCount() const
+    {
+        return spare_.size();
+    }
+
+private:
+    std::vector<Storage> spare_;
+};
+
+// Storage from the pool if there is one, a new one otherwise
+template<class Value>
+std::vector<Voxel<Value>> acquireStorage(
+        RasterPool<Value>* pool,
+        size_t capacity)
+{
+    if (pool) {
+        return pool->acquire(capacity);
+    }
+    std::vector<Voxel<Value>> result;
+    result.reserve(capacity);
+    return result;
+}
+// Storage is just dropped without a pool
+template<class Value>
+void recycleStorage(
+        RasterPool<Value>* pool,
+        std::vector<Voxel<Value>> storage)
+{
+    if (pool) {
+        pool->recycle(std::move(storage));
+    }
+}
+template<class Value>
+void recycleStorage(
+        RasterPool<Value>* pool,
+        VectorSparseRaster<Value>* raster)
+{
+    if (pool) {
+        pool->recycle(raster);
+    }
+}
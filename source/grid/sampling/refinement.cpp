@@ -11,17 +11,57 @@
 
 #include <limits>
 
-Box voxelsBoundingBox(const std::vector<Coordinates>& selection)
+namespace {
+
+// Appends the children of the parents within [begin, end) sharing
+// the coordinates before the axis, the child prefix is set already
+void appendChildren(
+        const std::vector<Voxel<Location>>& sortedParents,
+        size_t begin,
+        size_t end,
+        size_t axis,
+        Coordinates child,
+        std::vector<Voxel<Location>>* result)
+{
+    if (axis == DIMS) {
+        assert(end == begin + 1);
+        result->emplace_back(child, sortedParents[begin].value);
+        return;
+    }
+
+    const auto scale = static_cast<int>(REFINEMENT_SCALE);
+    while (begin < end) {
+        const int parentCoordinate =
+            sortedParents[begin].coordinates()[axis];
+        size_t runEnd = begin + 1;
+        while (runEnd < end &&
+                sortedParents[runEnd].coordinates()[axis] ==
+                    parentCoordinate) {
+            ++runEnd;
+        }
+
+        for (int offset = 0; offset < scale; ++offset) {
+            child[axis] = parentCoordinate * scale + offset;
+            appendChildren(
+                sortedParents, begin, runEnd, axis + 1, child, result);
+        }
+        begin = runEnd;
+    }
+}
+
+} // namespace
+
+Box voxelsBoundingBox(const Generator<const Coordinates&>& selection)
 {
     auto min = Coordinates::constant(std::numeric_limits<int>::max());
     auto max = Coordinates::constant(0);
 
-    for (const auto& coordinates : selection) {
+    selection.process([&] (const Coordinates& coordinates) {
         for (size_t i = 0; i < DIMS; ++i) {
             min[i] = std::min(min[i], coordinates[i]);
             max[i] = std::max(max[i], coordinates[i]);
         }
-    }
+    });
 
     max += Coordinates::constant(1);
     // Align the box to voxel boundaries
@@ -38,3 +78,16 @@ Box voxelsBoundingBox(const std::vector<Coordinates>& selection)
         max.cast<double>().eval()
     };
 }
+
+void appendRefinedVoxels(
+        const std::vector<Voxel<Location>>& sortedParents,
+        std::vector<Voxel<Location>>* result)
+{
+    appendChildren(
+        sortedParents,
+        0,
+        sortedParents.size(),
+        0,
+        Coordinates::constant(0),
+        result);
+}
@@ -11,32 +11,45 @@
 #include "geometry/kernel.h"
 #include "geometry/location/location.h"
 #include "grid/sampling/mapper.h"
+#include "grid/sampling/raster_pool.h"
 #include "grid/sampling/sparse_raster.h"
-#include "grid/sampling/xd_iterator.h"
+#include "utility/generator.h"
 
 #include <vector>
 
 static const size_t REFINEMENT_SCALE = 2;
 
 // Returns box perfectly aligned to voxel boundaries
-Box voxelsBoundingBox(const std::vector<Coordinates>& selection);
+Box voxelsBoundingBox(const Generator<const Coordinates&>& selection);
+
+// Children of the voxels in the raster order taking the values
+// of their parents, the parents are to be in the raster order as well
+void appendRefinedVoxels(
+        const std::vector<Voxel<Location>>& sortedParents,
+        std::vector<Voxel<Location>>* result);
 
 // Removes all the empty voxels from the sampling and shrinks container
 // Returns sampling filled with boundary(undefined) values.
+// The result storage is taken from the pool if there is one.
 // NB. Subsequent shrinks/refines should be correct in any order!
 template<template<class> class Sampling>
-Sampling<Location> shrink(const Sampling<Location>& sampling)
+Sampling<Location> shrink(
+        const Sampling<Location>& sampling,
+        RasterPool<Location>* pool = nullptr)
 {
-    // Selection is iterated twice here
-    std::vector<Coordinates> selection;
-    selection.reserve(sampling.size());
+    auto voxels = acquireStorage(pool, sampling.size());
     sampling.voxels().process([&] (const auto& voxel) {
         if (voxel.value != Location::Outer) {
-            selection.push_back(voxel.coordinates());
+            voxels.emplace_back(voxel.coordinates(), Location::Boundary);
         }
     });
 
-    const auto localContainer = voxelsBoundingBox(selection);
+    const auto localContainer = voxelsBoundingBox(
+        mapGenerator<const Coordinates&>(
+            Generator<const Voxel<Location>&>(&voxels),
+            [] (const auto& voxel) {
+                return voxel.coordinates();
+            }));
     const size_t gridSize = static_cast<size_t>(
         intFloor(localContainer.radius() * 2.));
     const Mapper mapper(sampling.toGlobal(localContainer), gridSize);
@@ -49,49 +62,42 @@ Sampling<Location> shrink(const Sampling<Location>& sampling)
     const auto offset = (intFloor(localContainer.center()) -
         Coordinates::constant(gridSize / 2)).eval();
 
-    for (auto& coordinates : selection) {
-        auto resultCoordinates = (coordinates - offset).eval();
+    for (auto& voxel : voxels) {
+        auto resultCoordinates = (voxel.coordinates() - offset).eval();
         assert(mapper.contains(resultCoordinates));
-        coordinates = std::move(resultCoordinates);
+        voxel = Voxel<Location>{std::move(resultCoordinates), voxel.value};
     }
 
+    // Shifting keeps the raster order
     return {
         mapper,
-        typename Sampling<Location>::Raster{
-            selection,
-            Location::Boundary
-        }
+        Sampling<Location>::Raster::fromSortedVoxels(std::move(voxels))
     };
 }
 
 // Refines non-empty part of sampling
-// Returns sampling filled with boundary(undefined) values
+// Returns sampling filled with boundary(undefined) values.
+// The result storage is taken from the pool if there is one.
 // NB. Subsequent shrinks/refines should be correct in any order!
 template<template<class> class Sampling>
-Sampling<Location> refine(const Sampling<Location>& sampling)
+Sampling<Location> refine(
+        const Sampling<Location>& sampling,
+        RasterPool<Location>* pool = nullptr)
 {
-    auto selection = compositeGenerator<const Coordinates&>(
-        sampling.voxels(),
-        [&] (const auto& voxel, auto&& yield) {
-            if (voxel.value == Location::Outer) {
-                return;
-            }
+    auto parents = acquireStorage(pool, sampling.size());
+    sampling.voxels().process([&] (const auto& voxel) {
+        if (voxel.value != Location::Outer) {
+            parents.emplace_back(voxel.coordinates(), Location::Boundary);
+        }
+    });
 
-            XDIterator<DIMS>::run(
-                Coordinates::constant(REFINEMENT_SCALE),
-                [&] (const Coordinates& offset) {
-                    yield((voxel.coordinates() * REFINEMENT_SCALE
-                       + offset).eval());
-                });
-        });
+    auto voxels = acquireStorage(pool, parents.size() *
+        rasterCapacity(Coordinates::constant(REFINEMENT_SCALE)));
+    appendRefinedVoxels(parents, &voxels);
+    recycleStorage(pool, std::move(parents));
 
     return {
         Mapper{sampling.container(), sampling.gridSize() * REFINEMENT_SCALE},
-        typename Sampling<Location>::Raster{
-            selection,
-            Location::Boundary,
-            sampling.size() *
-                rasterCapacity(Coordinates::constant(REFINEMENT_SCALE))
-        }
+        Sampling<Location>::Raster::fromSortedVoxels(std::move(voxels))
     };
 }
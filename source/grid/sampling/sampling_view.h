@@ -0,0 +1,105 @@
+// This file is part of xdscribe
+//
+// Copyright (C) 2019 Sergey Karpukhin <contact@kserz.rocks>
+//
+// Licensed under GNU General Public License version 3.
+// Full license text is available in LICENSE file.
+
+#pragma once
+
+#include "grid/sampling/raster_pool.h"
+#include "grid/sampling/sampling.h"
+#include "grid/sampling/vector_sparse_raster.h"
+
+#include <functional>
+#include <vector>
+
+// Subset of the parent sampling voxels with values of its own.
+// Intended to be reused for a sequence of images over the same selection:
+// the parent is scanned only once on construction and then the selection
+// can only shrink, so no sorting or reallocation is ever needed.
+//
+// NB. Parent voxels are referenced directly, the parent must not be
+// restructured while the view exists.
+template<class Value>
+class SamplingView final :
+        public VectorSparseRaster<Value>,
+        public Sampling<Value>
+{
+public:
+    using Voxel = typename VectorSparseRaster<Value>::Voxel;
+    using Predicate = std::function<bool(const Value&)>;
+
+    // Selects the parent voxels with values satisfying the predicate.
+    // The voxels storage is taken from the pool if there is one,
+    // the view may give it back by recycleStorage(pool, &view).
+    SamplingView(
+            Sampling<Value>* parent,
+            Predicate selection,
+            Value value,
+            RasterPool<Value>* pool = nullptr);
+
+    void fill(Value value)
+    {
+        for (auto& voxel : this->sortedSelection_) {
+            voxel.value = value;
+        }
+    }
+
+    // Folds the view values into the parent ones by
+    // combine(Value* parentValue, const Value& viewValue)
+    // and drops the voxels no longer satisfying the selection predicate
+    template<class Combine>
+    void commit(const Combine& combine);
+
+private:
+    const Predicate selection_;
+    std::vector<Voxel*> parentVoxels_;
+};
+
+template<class Value>
+SamplingView<Value>::SamplingView(
+        Sampling<Value>* parent,
+        Predicate selection,
+        Value value,
+        RasterPool<Value>* pool)
+    : Sampling<Value>(*parent)
+    , selection_(std::move(selection))
+{
+    this->sortedSelection_ = acquireStorage(pool, parent->size());
+    parentVoxels_.reserve(parent->size());
+    parent->voxels().process([&] (Voxel& voxel) {
+        if (selection_(voxel.value)) {
+            // Parent voxels are already sorted
+            assert(this->sortedSelection_.empty() || preceding(
+                this->sortedSelection_.back().coordinates(),
+                voxel.coordinates()));
+            this->sortedSelection_.push_back(
+                Voxel{voxel.coordinates(), value});
+            parentVoxels_.push_back(&voxel);
+        }
+    });
+}
+
+template<class Value>
+template<class Combine>
+void SamplingView<Value>::commit(const Combine& combine)
+{
+    auto& voxels = this->sortedSelection_;
+    size_t selectedCount = 0;
+    for (size_t i = 0; i < voxels.size(); ++i) {
+        auto* parentVoxel = parentVoxels_[i];
+        combine(&parentVoxel->value, voxels[i].value);
+
+        if (selection_(parentVoxel->value)) {
+            if (selectedCount != i) {
+                voxels[selectedCount] = std::move(voxels[i]);
+                parentVoxels_[selectedCount] = parentVoxel;
+            }
+            ++selectedCount;
+        }
+    }
+    voxels.erase(voxels.begin() + selectedCount, voxels.end());
+    parentVoxels_.erase(
+        parentVoxels_.begin() + selectedCount, parentVoxels_.end());
+}
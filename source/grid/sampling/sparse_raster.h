@@ -7,12 +7,14 @@
 
 #pragma once
 
+#include "geometry/entity/bounding_box.h"
 #include "geometry/kernel.h"
 #include "grid/sampling/xd_iterator.h"
 #include "utility/generator.h"
 
 #include <functional>
 #include <memory>
+#include <vector>
 
 template<class Value>
 class Voxel final {
@@ -56,8 +58,97 @@ public:
     // All the voxels along the last axis direction
     // starting with a specified point
     virtual Generator<Voxel&> verticalSlice(const Coordinates& start) = 0;
+
+    // All the voxels inside an axis-aligned box, bounds are included
+    virtual Generator<Voxel&> boxSlice(
+            const Coordinates& min,
+            const Coordinates& max) = 0;
 };
 
+// Voxels intersecting a box given in raster coordinates,
+// the ones merely touching it may be included as well
+template<class Value>
+Generator<Voxel<Value>&> overlappingVoxels(
+        SparseRaster<Value>* raster,
+        const BoundingBox& box)
+{
+    return raster->boxSlice(
+        (intFloor(box.min()) - Coordinates::constant(1)).eval(),
+        intFloor(box.max()));
+}
+
+// Calls join(voxel, matchingVoxel(it)) for every voxel of the sequence,
+// where it is the position of the voxel in the range at the coordinates
+// shifted by the offset or nullptr if there is none. Both the sequence
+// and the range are to be in the raster order, those are merged
+// in a single pass.
+template<class Value, class Iterator, class MatchingVoxel, class Join>
+void joinSortedVoxels(
+        const Generator<Value&>& voxels,
+        Iterator begin,
+        Iterator end,
+        const MatchingVoxel& matchingVoxel,
+        const Coordinates& offset,
+        const Join& join)
+{
+    auto current = begin;
+    voxels.process([&] (Value& voxel) {
+        const auto target = (voxel.coordinates() + offset).eval();
+        assert(current == begin ||
+            preceding(matchingVoxel(current - 1)->coordinates(), target));
+        while (current != end &&
+                preceding(matchingVoxel(current)->coordinates(), target)) {
+            ++current;
+        }
+
+        const bool found = current != end &&
+            matchingVoxel(current)->coordinates() == target;
+        join(voxel, found ? matchingVoxel(current) : nullptr);
+    });
+}
+
+// Calls join(voxel, matchingVoxel) for every voxel of the first sequence,
+// the matching one is the voxel of the second sequence at the coordinates
+// shifted by the offset or nullptr if there is none.
+// Both sequences are to be in the raster order, so instead of a search
+// per voxel they are merged in a single pass. The voxels of the rasters
+// kept in vectors are walked right there, only the generated ones
+// are collected first.
+template<class Value, class MatchingValue, class Join>
+void joinVoxels(
+        const Generator<Value&>& voxels,
+        const Generator<MatchingValue&>& matchingVoxels,
+        const Coordinates& offset,
+        const Join& join)
+{
+    if (const auto storage = matchingVoxels.storage()) {
+        joinSortedVoxels(
+            voxels,
+            storage->begin(),
+            storage->end(),
+            [] (const auto& it) {
+                return &*it;
+            },
+            offset,
+            join);
+        return;
+    }
+
+    std::vector<MatchingValue*> matching;
+    matchingVoxels.process([&] (MatchingValue& voxel) {
+        matching.push_back(&voxel);
+    });
+    joinSortedVoxels(
+        voxels,
+        matching.begin(),
+        matching.end(),
+        [] (const auto& it) {
+            return *it;
+        },
+        offset,
+        join);
+}
+
 inline size_t rasterCapacity(const Coordinates& rasterSize)
 {
     size_t result = 1;
@@ -10,8 +10,11 @@
 #include "grid/sampling/sparse_raster.h"
 #include "grid/sampling/xd_iterator.h"
 #include "utility/generator.h"
+#include "utility/radix_sort.h"
 
 #include <algorithm>
+#include <cstdint>
+#include <utility>
 #include <vector>
 
 template<class Value>
@@ -33,6 +36,22 @@ public:
             const Coordinates& rasterSize,
             Value value);
 
+    // Selection is taken as it is, so it should be in the raster order
+    // and contain no duplicates
+    static VectorSparseRaster fromSorted(
+            const std::vector<Coordinates>& sortedSelection,
+            Value value);
+    // Voxels are taken as they are, so those should be in the raster order
+    // and contain no duplicates. Their storage is kept, so rasters
+    // can be built in recycled ones.
+    static VectorSparseRaster fromSortedVoxels(std::vector<Voxel> sortedVoxels);
+
+    // Hands the voxels storage over for reuse leaving the raster empty
+    std::vector<Voxel> releaseStorage()
+    {
+        return std::exchange(sortedSelection_, {});
+    }
+
     virtual size_t size() const override
     {
         return sortedSelection_.size();
@@ -93,7 +112,96 @@ public:
         });
     }
 
+    virtual Generator<Voxel&> boxSlice(
+            const Coordinates& min,
+            const Coordinates& max) override
+    {
+        return Generator<Voxel&>([this, min, max] (auto&& yield) {
+            if ((min.array() > max.array()).any()) {
+                return;
+            }
+
+            const auto seek = [this] (auto from, const Coordinates& target) {
+                return std::lower_bound(
+                    from, sortedSelection_.end(), target,
+                    [] (const auto& voxel, const auto& coordinates) {
+                        return preceding(voxel.coordinates(), coordinates);
+                    });
+            };
+
+            // Voxels outside the box are skipped by binary search
+            // for the next lexicographically suitable position
+            auto it = seek(sortedSelection_.begin(), min);
+            while (it != sortedSelection_.end()) {
+                auto target = it->coordinates();
+                size_t axis = 0;
+                while (axis < DIMS &&
+                        target[axis] >= min[axis] &&
+                        target[axis] <= max[axis]) {
+                    ++axis;
+                }
+
+                if (axis == DIMS) {
+                    yield(*it);
+                    ++it;
+                    continue;
+                }
+
+                if (target[axis] > max[axis]) {
+                    if (axis == 0) {
+                        break;
+                    }
+                    ++target[--axis];
+                }
+                for (size_t i = axis; i < DIMS; ++i) {
+                    if (i > axis || target[i] < min[i]) {
+                        target[i] = min[i];
+                    }
+                }
+                it = seek(it, target);
+            }
+        });
+    }
+
 protected:
+    // Empty raster to be filled by derived classes
+    VectorSparseRaster() = default;
+
+    // Coordinates packed into a key with the same ordering
+    static constexpr unsigned KEY_COORDINATE_BITS = 64 / DIMS;
+    static constexpr int KEY_COORDINATE_BIAS = 1 << (KEY_COORDINATE_BITS - 1);
+    static bool packable(const Coordinates& coordinates)
+    {
+        for (const auto coordinate : coordinates) {
+            if (coordinate < -KEY_COORDINATE_BIAS ||
+                    coordinate >= KEY_COORDINATE_BIAS) {
+                return false;
+            }
+        }
+        return true;
+    }
+    static uint64_t packKey(const Coordinates& coordinates)
+    {
+        uint64_t result = 0;
+        for (const auto coordinate : coordinates) {
+            result = (result << KEY_COORDINATE_BITS) |
+                static_cast<uint64_t>(coordinate + KEY_COORDINATE_BIAS);
+        }
+        return result;
+    }
+    static Coordinates unpackKey(uint64_t key)
+    {
+        constexpr uint64_t COORDINATE_MASK =
+            (uint64_t{1} << KEY_COORDINATE_BITS) - 1;
+        Coordinates result;
+        for (size_t i = DIMS; i-- > 0;) {
+            result[i] = static_cast<int>(key & COORDINATE_MASK) -
+                KEY_COORDINATE_BIAS;
+            key >>= KEY_COORDINATE_BITS;
+        }
+        return result;
+    }
+
     // Sorting is needed to produce correct slices and find to work
     std::vector<Voxel> sortedSelection_;
 };
@@ -104,13 +212,39 @@ VectorSparseRaster<Value>::VectorSparseRaster(
         Value value,
         size_t estimatedCapacity)
 {
-    sortedSelection_.reserve(estimatedCapacity);
+    // Note that the selection may come in an arbitrary order and
+    // grid_location adds multiple instances of the same voxel.
+    // Voxels are sorted as packed keys unless some coordinates do not fit.
+    std::vector<uint64_t> keys;
+    keys.reserve(estimatedCapacity);
+    bool fitKeys = true;
     selection.process([&] (const auto& coordinates) {
+        if (fitKeys && packable(coordinates)) {
+            keys.push_back(packKey(coordinates));
+            return;
+        }
+
+        if (fitKeys) {
+            fitKeys = false;
+            sortedSelection_.reserve(estimatedCapacity);
+            for (const auto key : keys) {
+                sortedSelection_.push_back(Voxel{unpackKey(key), value});
+            }
+            keys = {};
+        }
         sortedSelection_.push_back(Voxel{coordinates, value});
     });
 
-    // Note that refinement does not produce selection in the right order
-    // and grid_location adds multiple instances of the same voxel
+    if (fitKeys) {
+        radixSort(&keys);
+        keys.erase(std::unique(keys.begin(), keys.end()), keys.end());
+        sortedSelection_.reserve(keys.size());
+        for (const auto key : keys) {
+            sortedSelection_.push_back(Voxel{unpackKey(key), value});
+        }
+        return;
+    }
+
     std::sort(
         sortedSelection_.begin(),
         sortedSelection_.end(),
@@ -151,3 +285,33 @@ VectorSparseRaster<Value>::VectorSparseRaster(
           value,
           rasterCapacity(rasterSize))
 {}
+
+template<class Value>
+VectorSparseRaster<Value> VectorSparseRaster<Value>::fromSorted(
+        const std::vector<Coordinates>& sortedSelection,
+        Value value)
+{
+    VectorSparseRaster<Value> result;
+    result.sortedSelection_.reserve(sortedSelection.size());
+    for (const auto& coordinates : sortedSelection) {
+        assert(result.sortedSelection_.empty() || preceding(
+            result.sortedSelection_.back().coordinates(), coordinates));
+        result.sortedSelection_.push_back(Voxel{coordinates, value});
+    }
+    return result;
+}
+
+template<class Value>
+VectorSparseRaster<Value> VectorSparseRaster<Value>::fromSortedVoxels(
+        std::vector<Voxel> sortedVoxels)
+{
+    VectorSparseRaster<Value> result;
+    result.sortedSelection_ = std::move(sortedVoxels);
+    assert(std::adjacent_find(
+        result.sortedSelection_.begin(),
+        result.sortedSelection_.end(),
+        [] (const auto& lhs, const auto& rhs) {
+            return !preceding(lhs.coordinates(), rhs.coordinates());
+        }) == result.sortedSelection_.end());
+    return result;
+}
@@ -25,6 +25,7 @@ public:
         , count_(0)
     {}
 
+    // Not synchronized, values are only reported by the solver thread
     void report(Value value)
     {
         max_ = std::max(max_, value);
@@ -26,6 +26,8 @@
 #include "solver/inverse/graphic_inscriber.h"
 #include "solver/inverse/halfspace_part_rasterizer.h"
 #include "solver/inverse/minkowski_sum_rasterizer.h"
+#include "solver/inverse/morphology_ms_rasterizer.h"
+#include "solver/inverse/scale_interval_rasterizer.h"
 
 #include <cstddef>
 #include <functional>
@@ -208,20 +210,13 @@ const auto convexDecompositorFactory = [] (const auto description) {
         });
 };
 
-const auto facetRasterizerFactory =
-    selectionFactory<FacetRasterizer>(
-        "facet rasterizer",
-        {
-            {'b', Parametrized::valueFactory<FacetRasterizer>(
-                "bbox facet rasterizer", bBoxFacetRasterizer())},
-            {'o', Parametrized::valueFactory<FacetRasterizer>(
-                "overlap facet rasterizer", rasterizeFacetByOverlap)}
-        });
-
 const auto innerRegionRasterizerFactory =
     selectionFactory<InnerRegionRasterizer>(
         "inner rasterizer",
         {
+            {'c', Parametrized::valueFactory<InnerRegionRasterizer>(
+                 "component-wise inner rasterizer",
+                 rasterizeInnerRegionByComponents)},
             {'f', Parametrized::valueFactory<InnerRegionRasterizer>(
                  "facets-combined inner rasterizer",
                  rasterizeInnerRegionByFacets)},
@@ -233,39 +228,95 @@ const auto innerRegionRasterizerFactory =
                  rasterizeInnerRegionSequentally)}
         });
 
-const auto polytopeRasterizerFactory = [] (const auto description) {
+// Facet rasterizer followed by the inner region one
+const auto facetPolytopeRasterizerFactory = [] (
+        const auto description,
+        FacetRasterizer facetRasterizer) {
     return Parametrized::composition<
-            PolytopeRasterizer, FacetRasterizer, InnerRegionRasterizer>(
+            PolytopeRasterizer, InnerRegionRasterizer>(
         description,
-        {[] (
-                FacetRasterizer facetRasterizer,
+        {[facetRasterizer = std::move(facetRasterizer)] (
                 InnerRegionRasterizer innerRegionRasterizer,
                 auto...) {
             return polytopeRasterizer(
-                std::move(facetRasterizer),
+                facetRasterizer,
                 std::move(innerRegionRasterizer));
         }},
-        facetRasterizerFactory,
         innerRegionRasterizerFactory);
 };
 
+const auto polytopeRasterizerFactory = [] (const auto description) {
+    return selectionFactory<PolytopeRasterizer>(
+        description,
+        {
+            {'b', facetPolytopeRasterizerFactory(
+                "bbox facet rasterizer", bBoxFacetRasterizer())},
+            {'o', facetPolytopeRasterizerFactory(
+                "overlap facet rasterizer", rasterizeFacetByOverlap)},
+            {'s', facetPolytopeRasterizerFactory(
+                "scan-conversion facet rasterizer", rasterizeFacetByScanning)},
+            {'u', Parametrized::valueFactory<PolytopeRasterizer>(
+                "fused column-wise rasterizer",
+                rasterizePolytopeByColumns)}
+        });
+};
+
+const auto convexPartRasterizerFactory =
+    selectionFactory<ConvexPartRasterizer>(
+        "convex part rasterizer",
+        {
+            {'b', Parametrized::valueFactory<ConvexPartRasterizer>(
+                "block-culling halfspaces convex part rasterizer",
+                rasterizePartByBlocks)},
+            {'h', Parametrized::valueFactory<ConvexPartRasterizer>(
+                "halfspaces convex part rasterizer",
+                rasterizePartByHalfspaces)},
+            {'p', Parametrized::composition<
+                ConvexPartRasterizer, PolytopeRasterizer>(
+                    "polytope-based convex part rasterizer",
+                    {[] (PolytopeRasterizer polytopeRasterizer, auto...) {
+                        return polytopePartRasterizer(
+                            std::move(polytopeRasterizer));
+                    }},
+                    polytopeRasterizerFactory("convex part polytope rasterizer"))}
+        });
+
 const auto minkowskiSumRasterizerFactory =
     selectionFactory<MinkowskiSumRasterizer>(
         "minkowski sum rasterizer",
         {
+            {'b', Parametrized::valueFactory<MinkowskiSumRasterizer>(
+                "block-culling halfspaces minkowski sum rasterizer",
+                decomposingMSRasterizer(
+                    rasterizePartByBlocks))},
             {'h', Parametrized::valueFactory<MinkowskiSumRasterizer>(
                 "halfspaces minkowski sum rasterizer",
-                decomposingMSRasterizer<VectorSampling>(
+                decomposingMSRasterizer(
                     rasterizePartByHalfspaces))},
             {'p', Parametrized::composition<
                 MinkowskiSumRasterizer, PolytopeRasterizer>(
                     "polytope-based minkowski sum rasterizer",
                     {[] (PolytopeRasterizer polytopeRasterizer, auto...) {
-                        return decomposingMSRasterizer<VectorSampling>(
+                        return decomposingMSRasterizer(
                             polytopePartRasterizer(
                                 std::move(polytopeRasterizer)));
                     }},
-                    polytopeRasterizerFactory("convex part polytope rasterizer"))}
+                    polytopeRasterizerFactory("convex part polytope rasterizer"))},
+            {'t', Parametrized::composition<
+                MinkowskiSumRasterizer, ConvexPartRasterizer>(
+                    "multi-threaded minkowski sum rasterizer",
+                    {[] (ConvexPartRasterizer convexPartRasterizer, auto...) {
+                        return parallelDecomposingMSRasterizer(
+                            std::move(convexPartRasterizer));
+                    }},
+                    convexPartRasterizerFactory)},
+            {'i', Parametrized::valueFactory<MinkowskiSumRasterizer>(
+                "scale-interval halfspaces minkowski sum rasterizer",
+                scaleIntervalMSRasterizer())},
+            {'m', Parametrized::valueFactory<MinkowskiSumRasterizer>(
+                "voxel morphology minkowski sum rasterizer",
+                morphologyMSRasterizer(
+                    decomposingMSRasterizer(rasterizePartByHalfspaces)))}
         });
 
 const auto accuracyEstimatorFactory =
@@ -3,19 +3,52 @@
 #include "geometry/kernel.h"
 #include "solver/inscribed_radius.h"
 
+#include <cassert>
+
+void RefinementSelector::select(
+        double radius,
+        double radiusAccuracy,
+        const Sampling<Location>& probe,
+        Sampling<Location>* sampling)
+{
+    refining_ = false;
+    const bool leaveEmpty = radiusAccuracy < targetPrecision_;
+    joinVoxels(
+        sampling->voxels(),
+        probe.voxels(),
+        Coordinates::constant(0),
+        [&] (auto& voxel, const auto* probeVoxel) {
+            assert(probeVoxel);
+            if (leaveEmpty && probeVoxel->value == Location::Outer) {
+                voxel.value = Location::Outer;
+                droppedRadius_ =
+                    std::max(droppedRadius_, radius + radiusAccuracy);
+            } else if (voxel.value != Location::Outer) {
+                refining_ = true;
+            }
+        });
+}
+
 AccuracyEstimatorFactory lipschitzianAccuracyEstimatorFactory()
 {
     return [] (
             const DomainEstimator* /*domainEstimator*/,
             const Polytope* starShapedPattern,
-            double /*targetPrecision*/) -> ActualAccuracyEstimator {
+            double targetPrecision,
+            RasterPool<Location>* /*rasterPool*/) -> ActualAccuracyEstimator {
         auto gridLipschitzConstant =
             InscribedRadius::lipschitzConstant(*starShapedPattern) * sqrt(DIMS);
-        return [gridLipschitzConstant] (
-                double /*radius*/,
+        return [
+                gridLipschitzConstant,
+                selector = RefinementSelector(targetPrecision)] (
+                double radius,
                 double radiusAccuracy,
-                const Sampling<Location>& sampling) {
-            return radiusAccuracy + gridLipschitzConstant * sampling.gridStep();
+                const Sampling<Location>& probe,
+                Sampling<Location>* sampling) mutable {
+            selector.select(radius, radiusAccuracy, probe, sampling);
+            return selector.accuracy(
+                radius,
+                radiusAccuracy + gridLipschitzConstant * sampling->gridStep());
         };
     };
 }
@@ -2,22 +2,64 @@
 
 #include "geometry/entity/polytope.h"
 #include "geometry/location/location.h"
+#include "grid/sampling/raster_pool.h"
 #include "grid/sampling/sampling.h"
 #include "solver/inverse/domain_estimator.h"
 
+#include <algorithm>
 #include <functional>
+#include <limits>
 
 // Returns a proven upper bound on difference
 // between radius and global optimal solution
-// within inverse graphic solver
+// within inverse graphic solver.
+// The probe is the domain estimated over the sampling voxels for
+// radius + radiusAccuracy that has no filled voxels. The estimator marks
+// outer the sampling voxels not worth refining, see refine().
 using ActualAccuracyEstimator = std::function<double(
     double radius,
     double radiusAccuracy,
-    const Sampling<Location>& sampling)>;
+    const Sampling<Location>& probe,
+    Sampling<Location>* sampling)>;
 
+// Leaves the refinement to the voxels where the accuracy requires it.
+// Once the radius step is below the target precision, the voxels empty
+// for the probe only hold solutions within the step of the radius,
+// so they are left out. The greatest radius of those is kept for
+// the accuracy to cover the solutions apart from the sampling.
+class RefinementSelector final {
+public:
+    explicit RefinementSelector(double targetPrecision)
+        : targetPrecision_(targetPrecision)
+    {}
+
+    // Marks outer the sampling voxels left out
+    void select(
+            double radius,
+            double radiusAccuracy,
+            const Sampling<Location>& probe,
+            Sampling<Location>* sampling);
+
+    // Accuracy over all the voxels given the one of the voxels left
+    // to refine by the latest selection
+    double accuracy(double radius, double refinedAccuracy) const
+    {
+        const double droppedAccuracy = droppedRadius_ - radius;
+        return refining_ ?
+            std::max(refinedAccuracy, droppedAccuracy) : droppedAccuracy;
+    }
+
+private:
+    const double targetPrecision_;
+    double droppedRadius_ = -std::numeric_limits<double>::infinity();
+    bool refining_ = true;
+};
+
+// Samplings are built in the storages of the pool if there is one
 using AccuracyEstimatorFactory = std::function<ActualAccuracyEstimator(
     const DomainEstimator* domainEstimator,
     const Polytope* starShapedPattern,
-    double targetPrecision)>;
+    double targetPrecision,
+    RasterPool<Location>* rasterPool)>;
 
 AccuracyEstimatorFactory lipschitzianAccuracyEstimatorFactory();
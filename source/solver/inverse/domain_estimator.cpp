@@ -1,7 +1,155 @@
 #include "domain_estimator.h"
 
+#include "geometry/location/packed_locations.h"
+#include "grid/sampling/packed_location_image.h"
+#include "grid/sampling/refinement.h"
+#include "grid/sampling/sampling_view.h"
 #include "grid/sampling/vector_sparse_raster.h"
 
+#include <optional>
+#include <vector>
+
+namespace {
+
+// Minkowski sum image of the latest estimation
+struct PreviousImage final {
+    double radius;
+    PackedLocationImage image;
+};
+
+// Inner voxels of the image stay inner for any greater radius
+// since the sum grows with the star-shaped pattern
+void reuseInnerVoxels(
+        const PreviousImage& previous,
+        double radius,
+        VectorSampling<Location>* image)
+{
+    if (radius < previous.radius) {
+        return;
+    }
+
+    const auto offset = alignmentOffset(*image, previous.image);
+    if (!offset) {
+        return;
+    }
+
+    previous.image.join(
+        image->voxels(),
+        *offset,
+        [] (auto& voxel, const Location* previousLocation) {
+            if (previousLocation && *previousLocation == Location::Inner) {
+                voxel.value = Location::Inner;
+            }
+        });
+}
+
+// Values of the cached image in the order of the sampling voxels,
+// returns false if the image does not cover the sampling
+bool cachedLocations(
+        const PackedLocationImage& cache,
+        const Sampling<Location>& sampling,
+        PackedLocations* result)
+{
+    result->clear();
+    const auto offset = alignmentOffset(sampling, cache);
+    if (!offset) {
+        return false;
+    }
+
+    result->reserve(sampling.size());
+    bool covered = true;
+    cache.join(
+        sampling.voxels(),
+        *offset,
+        [&] (const auto& /*voxel*/, const Location* cached) {
+            if (!cached) {
+                covered = false;
+            } else if (covered) {
+                result->push_back(*cached);
+            }
+        });
+    return covered;
+}
+
+// Domain locations of 32 voxels at once given the minkowski sum image
+// and the contour ones: inner voxels of the image do not contain a good
+// solution and neither do the outer ones of the contour, so those are
+// empty; the rest outer for the image are filled.
+uint64_t domainLocations(uint64_t imageWord, uint64_t contourWord)
+{
+    const auto low = PackedLocations::LOW_BITS;
+    const uint64_t imageInner = (imageWord >> 1) & low;
+    const uint64_t imageOuter = ~(imageWord | (imageWord >> 1)) & low;
+    const uint64_t contourOuter = ~(contourWord | (contourWord >> 1)) & low;
+
+    const uint64_t empty = imageInner | contourOuter;
+    const uint64_t filled = imageOuter & ~empty;
+    const uint64_t boundary = ~(empty | filled) & low;
+    return (filled << 1) | boundary;
+}
+
+// Sampling voxels come in the raster order
+VectorSampling<Location> emptyImage(
+        const Sampling<Location>& sampling,
+        RasterPool<Location>* pool)
+{
+    auto voxels = acquireStorage(pool, sampling.size());
+    sampling.voxels().process([&] (const auto& voxel) {
+        voxels.emplace_back(voxel.coordinates(), Location::Outer);
+    });
+    return {
+        sampling,
+        VectorSparseRaster<Location>::fromSortedVoxels(std::move(voxels))
+    };
+}
+
+bool isBoundary(Location value)
+{
+    return value == Location::Boundary;
+}
+
+// Carries the locations of the parent grid image down to the voxels
+// of its refinement: children of inner and outer voxels are such too,
+// the rest are left boundary. Returns false for a grid not refining
+// the parent one.
+// Children of the parents come in the raster order, so they are merged
+// with the image in a single pass instead of a search per voxel.
+bool inheritLocations(
+        const PackedLocationImage& parentImage,
+        VectorSampling<Location>* image,
+        RasterPool<Location>* pool)
+{
+    const Mapper refinedParent{
+        parentImage.container(),
+        parentImage.gridSize() * REFINEMENT_SCALE};
+    const auto offset = alignmentOffset(*image, refinedParent);
+    if (!offset) {
+        return false;
+    }
+
+    auto parents = acquireStorage(pool, parentImage.size());
+    parentImage.process([&] (
+            const Coordinates& coordinates, Location location) {
+        parents.emplace_back(coordinates, location);
+    });
+    auto children = acquireStorage(pool, parents.size() *
+        rasterCapacity(Coordinates::constant(REFINEMENT_SCALE)));
+    appendRefinedVoxels(parents, &children);
+    recycleStorage(pool, std::move(parents));
+
+    joinVoxels(
+        image->voxels(),
+        Generator<const Voxel<Location>&>(&children),
+        *offset,
+        [] (auto& voxel, const auto* child) {
+            voxel.value = child ? child->value : Location::Boundary;
+        });
+    recycleStorage(pool, std::move(children));
+    return true;
+}
+
+} // namespace
+
 DomainEstimatorFactory graphicDomainEstimatorFactory(
         MinkowskiSumRasterizer minkowskiSumRasterizer,
         PolytopeRasterizer contourRasterizer)
@@ -10,45 +158,75 @@ DomainEstimatorFactory graphicDomainEstimatorFactory(
             msumRasterizer = std::move(minkowskiSumRasterizer),
             contourRasterizer = std::move(contourRasterizer)] (
             const MinkowskiSum* minkowskiSum,
-            const Polytope* contour) -> DomainEstimator
+            const Polytope* contour,
+            RasterPool<Location>* rasterPool) -> DomainEstimator
     {
         return [
                 msumRasterizer,
                 contourRasterizer,
                 minkowskiSum,
-                contour] (
-                const Sampling<Location>& sampling, double radius) {
-            VectorSampling<Location> result{
-                sampling,
-                VectorSparseRaster{
-                    mapGenerator<const Coordinates&>(
-                        sampling.voxels(),
-                        [] (const auto& voxel) {
-                            return voxel.coordinates();
-                        }),
-                    Location::Outer,
-                    sampling.size()
-                }
-            };
-            VectorSparseRaster<Location> feasibility = result;
+                contour,
+                rasterPool,
+                previousImage = std::optional<PreviousImage>{},
+                contourImage = std::optional<PackedLocationImage>{},
+                feasibility = PackedLocations{},
+                domain = PackedLocations{}] (
+                const Sampling<Location>& sampling, double radius) mutable {
+            auto result = emptyImage(sampling, rasterPool);
 
+            // Radii only grow on the same grid, so the rasterizer
+            // is left with the voxels not yet covered by the image
+            if (previousImage) {
+                reuseInnerVoxels(*previousImage, radius, &result);
+            }
             msumRasterizer(*minkowskiSum, radius, &result);
-            contourRasterizer(
-                        sampling.toLocal(contour->facetGeometries()),
-                        &feasibility);
-
-            result.voxels().process([&] (auto& voxel) {
-                auto* feasibilityVoxel = feasibility.find(voxel.coordinates());
-                assert(feasibilityVoxel);
+            previousImage = PreviousImage{radius, PackedLocationImage(result)};
 
-                // Inner voxels of the image do not contain a good solution,
-                // thus they are empty for a problem.
-                if (voxel.value == Location::Inner ||
-                        feasibilityVoxel->value == Location::Outer) {
+            // Image covering the whole sampling leaves the domain empty
+            // regardless of the contour
+            const auto& imageLocations = previousImage->image.locations();
+            if (imageLocations.count(Location::Inner) == result.size()) {
+                result.voxels().process([] (auto& voxel) {
                     voxel.value = Location::Outer;
-                } else if (voxel.value == Location::Outer) {
-                    voxel.value = Location::Inner;
+                });
+                return result;
+            }
+
+            // The contour image does not depend on the radius,
+            // it is only rasterized once the sampling leaves the cached grid
+            if (!contourImage ||
+                    !cachedLocations(*contourImage, sampling, &feasibility)) {
+                auto image = emptyImage(sampling, rasterPool);
+                if (contourImage && inheritLocations(
+                        *contourImage, &image, rasterPool)) {
+                    // Only the children of the boundary voxels are unknown
+                    SamplingView<Location> undefined(
+                        &image, isBoundary, Location::Outer, rasterPool);
+                    contourRasterizer(
+                                sampling.toLocal(contour->facetGeometries()),
+                                &undefined);
+                    undefined.commit([] (Location* value, Location location) {
+                        *value = location;
+                    });
+                    recycleStorage(rasterPool, &undefined);
+                } else {
+                    contourRasterizer(
+                                sampling.toLocal(contour->facetGeometries()),
+                                &image);
                 }
+                contourImage.emplace(image);
+                recycleStorage(rasterPool, &image);
+                const bool cached =
+                    cachedLocations(*contourImage, sampling, &feasibility);
+                assert(cached);
+                (void)cached;
+            }
+
+            PackedLocations::transform(
+                imageLocations, feasibility, domainLocations, &domain);
+            size_t index = 0;
+            result.voxels().process([&] (auto& voxel) {
+                voxel.value = domain[index++];
             });
 
             return result;
@@ -3,6 +3,7 @@
 #include "geometry/entity/polytope.h"
 #include "geometry/location/location.h"
 #include "grid/rasterization/polytope_rasterizer.h"
+#include "grid/sampling/raster_pool.h"
 #include "grid/sampling/sampling.h"
 #include "grid/sampling/vector_sampling.h"
 #include "solver/inverse/minkowski_sum.h"
@@ -19,10 +20,19 @@ using DomainEstimator = std::function<VectorSampling<Location>(
     const Sampling<Location>& sampling,
     double radius)>;
 
+// Images are built in the storages of the pool if there is one,
+// so the caller may return the results it is done with there
 using DomainEstimatorFactory = std::function<DomainEstimator(
     const MinkowskiSum* minkowskiSum,
-    const Polytope* contour)>;
+    const Polytope* contour,
+    RasterPool<Location>* rasterPool)>;
 
+// Every estimator keeps the latest minkowski sum image and reuses
+// its inner voxels for a greater radius on an aligned grid.
+// The contour image is kept for a grid while the samplings
+// stay within it, after a refinement only the children of
+// its boundary voxels are rasterized again.
+// Both images are cached packed, see PackedLocationImage.
 DomainEstimatorFactory graphicDomainEstimatorFactory(
         MinkowskiSumRasterizer minkowskiSumRasterizer,
         PolytopeRasterizer contourRasterizer);
@@ -10,28 +10,40 @@ AccuracyEstimatorFactory generalAccuracyEstimatorFactory()
     return [] (
             const DomainEstimator* domainEstimator,
             const Polytope* /*starShapedPattern*/,
-            double targetPrecision) -> ActualAccuracyEstimator
+            double targetPrecision,
+            RasterPool<Location>* rasterPool) -> ActualAccuracyEstimator
     {
-        return [domainEstimator, targetPrecision] (
+        return [
+                domainEstimator,
+                targetPrecision,
+                rasterPool,
+                selector = RefinementSelector(targetPrecision)] (
                 double radius,
                 double radiusAccuracy,
-                const Sampling<Location>& sampling) -> double {
+                const Sampling<Location>& probe,
+                Sampling<Location>* sampling) mutable -> double {
+            selector.select(radius, radiusAccuracy, probe, sampling);
+
+            // Only the voxels left to refine are estimated,
+            // sampling voxels come in the raster order
             double result = radiusAccuracy;
-            VectorSampling<Location> accuracySampling{
-                sampling,
-                VectorSparseRaster{
-                    mapGenerator<const Coordinates&>(
-                        sampling.voxels(),
-                        [] (const auto& voxel) {
-                            return voxel.coordinates();
-                        }),
-                    Location::Outer,
-                    sampling.size()
+            auto voxels = acquireStorage(rasterPool, sampling->size());
+            sampling->voxels().process([&] (const auto& voxel) {
+                if (voxel.value != Location::Outer) {
+                    voxels.emplace_back(voxel.coordinates(), Location::Outer);
                 }
+            });
+            VectorSampling<Location> accuracySampling{
+                *sampling,
+                VectorSparseRaster<Location>::fromSortedVoxels(
+                    std::move(voxels))
             };
 
+            // Radii grow on the shrinking samplings of the same grid,
+            // so the estimator only rasterizes the voxels it has not
+            // covered by the image for a smaller one
             while (result < targetPrecision + MEPS) {
-                const auto newSampling = (*domainEstimator)(
+                auto newSampling = (*domainEstimator)(
                     accuracySampling, radius + result);
 
                 bool haveNonEmptyVoxels = false;
@@ -43,13 +55,17 @@ AccuracyEstimatorFactory generalAccuracyEstimatorFactory()
 
                 if (haveNonEmptyVoxels) {
                     result += radiusAccuracy;
-                    accuracySampling = shrink(newSampling);
-                } else {
+                    recycleStorage(rasterPool, &accuracySampling);
+                    accuracySampling = shrink(newSampling, rasterPool);
+                }
+                recycleStorage(rasterPool, &newSampling);
+                if (!haveNonEmptyVoxels) {
                     break;
                 }
             }
+            recycleStorage(rasterPool, &accuracySampling);
 
-            return result;
+            return selector.accuracy(radius, result);
         };
     };
 }
@@ -23,6 +23,7 @@ GraphicInscriber::GraphicInscriber(
 {}
 
 GraphicInscriber::GraphicIteration::GraphicIteration(
+        std::unique_ptr<RasterPool<Location>> rasterPool,
         std::unique_ptr<MinkowskiSum> minkowskiSum,
         std::unique_ptr<DomainEstimator> domainEstimator,
         std::unique_ptr<ActualAccuracyEstimator> actualAccuracyEstimator,
@@ -30,6 +31,7 @@ GraphicInscriber::GraphicIteration::GraphicIteration(
     : Iteration(
           sampling.container().radius(),
           Placement{sampling.container().center(), 0.})
+    , rasterPool_(std::move(rasterPool))
     , minkowskiSum_(std::move(minkowskiSum))
     , domainEstimator_(std::move(domainEstimator))
     , actualAccuracyEstimator_(std::move(actualAccuracyEstimator))
@@ -43,17 +45,20 @@ GraphicInscriber::init(
         const Polytope* contour,
         double targetPrecision) const
 {
+    auto rasterPool = std::make_unique<RasterPool<Location>>();
     const auto invertedPattern = Polytope::invert(*pattern);
     auto minkowskiSum = std::make_unique<MinkowskiSum>(
         *contour,
         convexDecompositor_(&invertedPattern));
     auto domainEstimator = std::make_unique<DomainEstimator>(
-        domainEstimatorFactory_(minkowskiSum.get(), contour));
+        domainEstimatorFactory_(
+            minkowskiSum.get(), contour, rasterPool.get()));
     auto actualAccuracyEstimator = std::make_unique<ActualAccuracyEstimator>(
         accuracyEstimatorFactory_(
             domainEstimator.get(),
             pattern,
-            targetPrecision));
+            targetPrecision,
+            rasterPool.get()));
     // Initially all the voxels are in undefined state
     const auto sampling = VectorSampling<Location>{
         boundingBox(contour->vertices()),
@@ -61,6 +66,7 @@ GraphicInscriber::init(
         Location::Boundary};
 
     return std::make_unique<GraphicIteration>(
+        std::move(rasterPool),
         std::move(minkowskiSum),
         std::move(domainEstimator),
         std::move(actualAccuracyEstimator),
@@ -72,7 +78,7 @@ std::unique_ptr<IterativeInscriber::Iteration> GraphicInscriber::iterate(
 {
     auto& it = static_cast<GraphicIteration&>(*iteration);
 
-    const auto newSampling = (*it.domainEstimator_)(
+    auto newSampling = (*it.domainEstimator_)(
         it.sampling,
         it.solution.radius() + it.radiusStep);
 
@@ -93,17 +99,26 @@ std::unique_ptr<IterativeInscriber::Iteration> GraphicInscriber::iterate(
             it.solution.radius() + it.radiusStep
         };
 
-        it.sampling = shrink(newSampling);
+        auto shrunk = shrink(newSampling, it.rasterPool_.get());
+        it.rasterPool_->recycle(&it.sampling);
+        it.sampling = std::move(shrunk);
     } else {
+        // Voxels empty for the failed radius may still hold solutions for
+        // the smaller ones probed next, the estimator leaves out the ones
+        // of those the target precision does not require to refine
         it.precision = (*it.actualAccuracyEstimator_)(
             it.solution.radius(),
             it.radiusStep,
-            it.sampling);
+            newSampling,
+            &it.sampling);
 
-        it.sampling = refine(it.sampling);
+        auto refined = refine(it.sampling, it.rasterPool_.get());
+        it.rasterPool_->recycle(&it.sampling);
+        it.sampling = std::move(refined);
 
         it.radiusStep /= 2.;
     }
+    it.rasterPool_->recycle(&newSampling);
 
     return std::move(iteration);
 }
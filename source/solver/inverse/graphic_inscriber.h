@@ -9,6 +9,7 @@
 
 #include "geometry/convex_decomposition/convex_decomposition.h"
 #include "geometry/location/location.h"
+#include "grid/sampling/raster_pool.h"
 #include "grid/sampling/vector_sampling.h"
 #include "solver/inverse/accuracy_estimator.h"
 #include "solver/inverse/domain_estimator.h"
@@ -25,11 +26,15 @@ public:
 private:
     struct GraphicIteration : public Iteration {
         GraphicIteration(
+                std::unique_ptr<RasterPool<Location>> rasterPool,
                 std::unique_ptr<MinkowskiSum> minkowskiSum,
                 std::unique_ptr<DomainEstimator> domainEstimator,
                 std::unique_ptr<ActualAccuracyEstimator> actualAccuracyEstimator,
                 VectorSampling<Location> sampling);
 
+        // Storages of the samplings of the previous iterations,
+        // the estimators build theirs there as well
+        const std::unique_ptr<RasterPool<Location>> rasterPool_;
         const std::unique_ptr<MinkowskiSum> minkowskiSum_;
         const std::unique_ptr<DomainEstimator> domainEstimator_;
         const std::unique_ptr<ActualAccuracyEstimator> actualAccuracyEstimator_;
@@ -0,0 +1,237 @@
+// This file is part of xdscribe
+//
+// Copyright (C) 2019 Sergey Karpukhin <contact@kserz.rocks>
+//
+// Licensed under GNU General Public License version 3.
+// Full license text is available in LICENSE file.
+
+#include "halfspace_classifier.h"
+
+#include <algorithm>
+#include <cassert>
+
+#if defined(__GNUC__) && defined(__x86_64__)
+#define XDSCRIBE_X86_SIMD
+#include <immintrin.h>
+#endif
+
+// Every kernel rounds each operation as the Eigen dot product does,
+// so products are never fused with the sums into FMA instructions
+#if defined(__clang__)
+#pragma STDC FP_CONTRACT OFF
+#elif defined(__GNUC__)
+#pragma GCC optimize("fp-contract=off")
+#endif
+
+namespace {
+
+// Operations order matches Eigen dot product for identical results
+Location classifyVoxel(
+        const LocalHalfspaces& halfspaces,
+        double x, double y, double z)
+{
+    Location result = Location::Inner;
+    for (size_t j = 0; j < halfspaces.size(); ++j) {
+        const double distance =
+            (halfspaces.normals[0][j] * (x + halfspaces.lowestPoints[0][j]) +
+             halfspaces.normals[1][j] * (y + halfspaces.lowestPoints[1][j])) +
+             halfspaces.normals[2][j] * (z + halfspaces.lowestPoints[2][j]) -
+            halfspaces.offsets[j];
+
+        if (distance > MEPS) {
+            return Location::Outer;
+        } else if (distance + halfspaces.sizeProjections[j] > -MEPS) {
+            result = Location::Boundary;
+        }
+    }
+    return result;
+}
+
+void classifyScalar(
+        const LocalHalfspaces& halfspaces,
+        const VoxelCorners& corners,
+        size_t begin,
+        Location* locations)
+{
+    const size_t count = corners[0].size();
+    for (size_t i = begin; i < count; ++i) {
+        locations[i] = classifyVoxel(
+            halfspaces, corners[0][i], corners[1][i], corners[2][i]);
+    }
+}
+
+inline Location blockLocation(unsigned outerBits, unsigned boundaryBits)
+{
+    if (outerBits & 1u) {
+        return Location::Outer;
+    }
+    return (boundaryBits & 1u) ? Location::Boundary : Location::Inner;
+}
+
+#ifdef XDSCRIBE_X86_SIMD
+
+// Vectorized kernels return the number of voxels processed
+
+__attribute__((target("avx2")))
+size_t classifyAVX2(
+        const LocalHalfspaces& halfspaces,
+        const VoxelCorners& corners,
+        Location* locations)
+{
+    constexpr size_t BLOCK = 4;
+    constexpr int ALL_LANES = (1 << BLOCK) - 1;
+    const size_t count = corners[0].size();
+    const __m256d outerThreshold = _mm256_set1_pd(MEPS);
+    const __m256d boundaryThreshold = _mm256_set1_pd(-MEPS);
+
+    size_t i = 0;
+    for (; i + BLOCK <= count; i += BLOCK) {
+        const __m256d x = _mm256_loadu_pd(&corners[0][i]);
+        const __m256d y = _mm256_loadu_pd(&corners[1][i]);
+        const __m256d z = _mm256_loadu_pd(&corners[2][i]);
+
+        __m256d outer = _mm256_setzero_pd();
+        __m256d boundary = _mm256_setzero_pd();
+        for (size_t j = 0; j < halfspaces.size(); ++j) {
+            const __m256d dx = _mm256_mul_pd(
+                _mm256_set1_pd(halfspaces.normals[0][j]),
+                _mm256_add_pd(x,
+                    _mm256_set1_pd(halfspaces.lowestPoints[0][j])));
+            const __m256d dy = _mm256_mul_pd(
+                _mm256_set1_pd(halfspaces.normals[1][j]),
+                _mm256_add_pd(y,
+                    _mm256_set1_pd(halfspaces.lowestPoints[1][j])));
+            const __m256d dz = _mm256_mul_pd(
+                _mm256_set1_pd(halfspaces.normals[2][j]),
+                _mm256_add_pd(z,
+                    _mm256_set1_pd(halfspaces.lowestPoints[2][j])));
+            const __m256d distance = _mm256_sub_pd(
+                _mm256_add_pd(_mm256_add_pd(dx, dy), dz),
+                _mm256_set1_pd(halfspaces.offsets[j]));
+
+            outer = _mm256_or_pd(outer,
+                _mm256_cmp_pd(distance, outerThreshold, _CMP_GT_OQ));
+            if (_mm256_movemask_pd(outer) == ALL_LANES) {
+                break;
+            }
+            boundary = _mm256_or_pd(boundary, _mm256_cmp_pd(
+                _mm256_add_pd(distance,
+                    _mm256_set1_pd(halfspaces.sizeProjections[j])),
+                boundaryThreshold, _CMP_GT_OQ));
+        }
+
+        const unsigned outerBits = _mm256_movemask_pd(outer);
+        const unsigned boundaryBits = _mm256_movemask_pd(boundary);
+        for (size_t lane = 0; lane < BLOCK; ++lane) {
+            locations[i + lane] = blockLocation(
+                outerBits >> lane, boundaryBits >> lane);
+        }
+    }
+    return i;
+}
+
+__attribute__((target("avx512f")))
+size_t classifyAVX512(
+        const LocalHalfspaces& halfspaces,
+        const VoxelCorners& corners,
+        Location* locations)
+{
+    constexpr size_t BLOCK = 8;
+    constexpr __mmask8 ALL_LANES = 0xFF;
+    const size_t count = corners[0].size();
+    const __m512d outerThreshold = _mm512_set1_pd(MEPS);
+    const __m512d boundaryThreshold = _mm512_set1_pd(-MEPS);
+
+    size_t i = 0;
+    for (; i + BLOCK <= count; i += BLOCK) {
+        const __m512d x = _mm512_loadu_pd(&corners[0][i]);
+        const __m512d y = _mm512_loadu_pd(&corners[1][i]);
+        const __m512d z = _mm512_loadu_pd(&corners[2][i]);
+
+        __mmask8 outer = 0;
+        __mmask8 boundary = 0;
+        for (size_t j = 0; j < halfspaces.size(); ++j) {
+            const __m512d dx = _mm512_mul_pd(
+                _mm512_set1_pd(halfspaces.normals[0][j]),
+                _mm512_add_pd(x,
+                    _mm512_set1_pd(halfspaces.lowestPoints[0][j])));
+            const __m512d dy = _mm512_mul_pd(
+                _mm512_set1_pd(halfspaces.normals[1][j]),
+                _mm512_add_pd(y,
+                    _mm512_set1_pd(halfspaces.lowestPoints[1][j])));
+            const __m512d dz = _mm512_mul_pd(
+                _mm512_set1_pd(halfspaces.normals[2][j]),
+                _mm512_add_pd(z,
+                    _mm512_set1_pd(halfspaces.lowestPoints[2][j])));
+            const __m512d distance = _mm512_sub_pd(
+                _mm512_add_pd(_mm512_add_pd(dx, dy), dz),
+                _mm512_set1_pd(halfspaces.offsets[j]));
+
+            // Only the lanes still active are compared
+            outer |= _mm512_mask_cmp_pd_mask(
+                static_cast<__mmask8>(~outer),
+                distance, outerThreshold, _CMP_GT_OQ);
+            if (outer == ALL_LANES) {
+                break;
+            }
+            boundary |= _mm512_mask_cmp_pd_mask(
+                static_cast<__mmask8>(~outer),
+                _mm512_add_pd(distance,
+                    _mm512_set1_pd(halfspaces.sizeProjections[j])),
+                boundaryThreshold, _CMP_GT_OQ);
+        }
+
+        for (size_t lane = 0; lane < BLOCK; ++lane) {
+            locations[i + lane] = blockLocation(
+                static_cast<unsigned>(outer) >> lane,
+                static_cast<unsigned>(boundary) >> lane);
+        }
+    }
+    return i;
+}
+
+#endif // XDSCRIBE_X86_SIMD
+
+} // namespace
+
+SimdLevel supportedSimdLevel()
+{
+#ifdef XDSCRIBE_X86_SIMD
+    static const SimdLevel result = [] {
+        __builtin_cpu_init();
+        if (__builtin_cpu_supports("avx512f")) {
+            return SimdLevel::AVX512;
+        }
+        if (__builtin_cpu_supports("avx2")) {
+            return SimdLevel::AVX2;
+        }
+        return SimdLevel::Scalar;
+    }();
+    return result;
+#else
+    return SimdLevel::Scalar;
+#endif
+}
+
+void classifyVoxels(
+        const LocalHalfspaces& halfspaces,
+        const VoxelCorners& corners,
+        Location* locations,
+        SimdLevel level)
+{
+    assert(DIMS == 3);
+    assert(corners[1].size() == corners[0].size());
+    assert(corners[2].size() == corners[0].size());
+    level = std::min(level, supportedSimdLevel());
+
+    size_t processed = 0;
+#ifdef XDSCRIBE_X86_SIMD
+    if (level == SimdLevel::AVX512) {
+        processed = classifyAVX512(halfspaces, corners, locations);
+    } else if (level == SimdLevel::AVX2) {
+        processed = classifyAVX2(halfspaces, corners, locations);
+    }
+#endif
+    // The tail not filling a whole block
+    classifyScalar(halfspaces, corners, processed, locations);
+}
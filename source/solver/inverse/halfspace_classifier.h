@@ -0,0 +1,53 @@
+// This file is part of xdscribe
+//
+// Copyright (C) 2019 Sergey Karpukhin <contact@kserz.rocks>
+//
+// Licensed under GNU General Public License version 3.
+// Full license text is available in LICENSE file.
+
+#pragma once
+
+#include "geometry/kernel.h"
+#include "geometry/location/location.h"
+
+#include <array>
+#include <vector>
+
+// Halfspaces in local coordinates packed as a structure of arrays.
+// For a voxel with the lower corner v and a halfspace j let
+//     distance = normal_j.dot(v + lowestPoint_j) - offset_j
+// The voxel is outer if distance > MEPS and touches the plane
+// if distance + sizeProjection_j > -MEPS.
+struct LocalHalfspaces final {
+    size_t size() const
+    {
+        return offsets.size();
+    }
+
+    std::array<std::vector<double>, DIMS> normals;
+    std::array<std::vector<double>, DIMS> lowestPoints;
+    std::vector<double> offsets;
+    std::vector<double> sizeProjections;
+};
+
+// Lower corners of the voxels packed as a structure of arrays
+using VoxelCorners = std::array<std::vector<double>, DIMS>;
+
+enum class SimdLevel {
+    Scalar = 0,
+    AVX2,
+    AVX512
+};
+
+// The best instruction set available on the running CPU
+SimdLevel supportedSimdLevel();
+
+// Locations of the voxels relative to the intersection of the halfspaces.
+// Voxels are processed in blocks for the vector instruction sets
+// and a block is done as soon as every its voxel is rejected.
+// Unsupported levels fall back to the best supported one.
+void classifyVoxels(
+        const LocalHalfspaces& halfspaces,
+        const VoxelCorners& corners,
+        Location* locations,
+        SimdLevel level = supportedSimdLevel());
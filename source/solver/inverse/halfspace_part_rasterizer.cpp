@@ -7,76 +7,234 @@
 
 #include "halfspace_part_rasterizer.h"
 
-#include "geometry/entity/perpendicular.h"
+#include "geometry/entity/bounding_box.h"
 #include "grid/rasterization/facet_box_overlap.h"
-#include "grid/rasterization/facet_rasterizer.h"
+#include "solver/inverse/halfspace_classifier.h"
+
+#include <algorithm>
+#include <limits>
+#include <vector>
 
 namespace {
 
-struct Halfspace {
-    Vector<> normal;
-    double planeOffset;
-};
+// Blocks are halved down to the leaf ones,
+// those are classified voxel by voxel
+const int LEAF_BLOCK_SIZE = 4;
+// Block bounds are not computed the same way as the voxel distances,
+// so only the blocks decided with a margin are trusted
+const double BLOCK_MARGIN = MEPS;
 
-Halfspace outsideOrientedHalfspace(
-        const Facet& localFacet,
-        const Facet& baseFacet,
-        const Vector<> innerDirection)
+LocalHalfspaces localHalfspaces(
+        const MinkowskiSum::ConvexPart& convexPart,
+        const Sampling<Location>& partSampling)
 {
-    Halfspace result;
-    result.normal = unitNormal(localFacet);
-    result.planeOffset = result.normal.dot(localFacet[0]);
+    const auto& halfspaces = convexPart.halfspaces;
+    LocalHalfspaces result;
+    for (size_t j = 0; j < halfspaces.size(); ++j) {
+        Vector<> normal;
+        for (size_t i = 0; i < DIMS; ++i) {
+            normal[i] = halfspaces.normals[i][j];
+        }
+        const double offset = halfspaces.offsets0[j] +
+            convexPart.patternScale * halfspaces.offsetSlopes[j];
 
-    double innerOffset = 0.;
-    for (size_t i = 0; std::fabs(innerOffset) < MEPS && i < DIMS; ++i) {
-        innerOffset = result.normal.dot(baseFacet[i]) - result.planeOffset;
+        // Voxels are unit cubes in local coordinates
+        const auto lowestPoint = FacetBoxOverlap::lowestPoint(
+            Vector<>::Constant(1.), normal);
+        for (size_t i = 0; i < DIMS; ++i) {
+            result.normals[i].push_back(normal[i]);
+            result.lowestPoints[i].push_back(lowestPoint[i]);
+        }
+        // Mapping to local coordinates keeps the unit normal as it is
+        result.offsets.push_back(normal.dot(
+            partSampling.toLocal(Point((offset * normal).eval()))));
+        result.sizeProjections.push_back(normal.cwiseAbs().sum());
     }
-    if (std::fabs(innerOffset) < MEPS) {
-        innerOffset = result.normal.dot(innerDirection);
+    return result;
+}
+
+// Location shared by all the voxels within the bounds (included)
+// or the boundary one if they may differ
+Location blockLocation(
+        const LocalHalfspaces& halfspaces,
+        const Coordinates& min,
+        const Coordinates& max)
+{
+    Location result = Location::Inner;
+    for (size_t j = 0; j < halfspaces.size(); ++j) {
+        // Distances of the voxels in the block differ from the one of
+        // the lower voxel by the spreads at most
+        double distance = -halfspaces.offsets[j];
+        double lowSpread = 0.;
+        double highSpread = 0.;
+        for (size_t i = 0; i < DIMS; ++i) {
+            const double normal = halfspaces.normals[i][j];
+            distance += normal * (min[i] + halfspaces.lowestPoints[i][j]);
+            const double spread = normal * (max[i] - min[i]);
+            (spread < 0. ? lowSpread : highSpread) += spread;
+        }
+
+        if (distance + lowSpread > MEPS + BLOCK_MARGIN) {
+            return Location::Outer;
+        } else if (distance + highSpread + halfspaces.sizeProjections[j] >
+                -MEPS - BLOCK_MARGIN) {
+            result = Location::Boundary;
+        }
     }
-    assert(std::fabs(innerOffset) > MEPS);
+    return result;
+}
+
+using VoxelIterator = std::vector<Voxel<Location>*>::iterator;
 
-    if (innerOffset > 0.) {
-        result.normal = -result.normal;
-        result.planeOffset = -result.planeOffset;
+// Voxels of a block are the range given. Those left undecided
+// are gathered for the classification.
+void rasterizeBlock(
+        const LocalHalfspaces& halfspaces,
+        const Coordinates& min,
+        const Coordinates& max,
+        VoxelIterator begin,
+        VoxelIterator end,
+        std::vector<Voxel<Location>*>* partVoxels,
+        VoxelCorners* corners);
+
+// Splits the block in halves along the axes starting with the given one
+void splitBlock(
+        const LocalHalfspaces& halfspaces,
+        size_t axis,
+        const Coordinates& min,
+        const Coordinates& max,
+        VoxelIterator begin,
+        VoxelIterator end,
+        std::vector<Voxel<Location>*>* partVoxels,
+        VoxelCorners* corners)
+{
+    if (begin == end) {
+        return;
+    } else if (axis == DIMS) {
+        rasterizeBlock(halfspaces, min, max, begin, end, partVoxels, corners);
+        return;
+    } else if (min[axis] == max[axis]) {
+        splitBlock(
+            halfspaces, axis + 1, min, max, begin, end, partVoxels, corners);
+        return;
     }
 
-    return result;
+    const int middle = min[axis] + (max[axis] - min[axis] + 1) / 2;
+    const auto upperBegin = std::partition(begin, end, [&] (auto* voxel) {
+        return voxel->coordinates()[axis] < middle;
+    });
+    auto lowerMax = max;
+    lowerMax[axis] = middle - 1;
+    auto upperMin = min;
+    upperMin[axis] = middle;
+    splitBlock(
+        halfspaces, axis + 1, min, lowerMax,
+        begin, upperBegin, partVoxels, corners);
+    splitBlock(
+        halfspaces, axis + 1, upperMin, max,
+        upperBegin, end, partVoxels, corners);
 }
 
+void rasterizeBlock(
+        const LocalHalfspaces& halfspaces,
+        const Coordinates& min,
+        const Coordinates& max,
+        VoxelIterator begin,
+        VoxelIterator end,
+        std::vector<Voxel<Location>*>* partVoxels,
+        VoxelCorners* corners)
+{
+    const auto location = blockLocation(halfspaces, min, max);
+    if (location == Location::Outer) {
+        return;
+    } else if (location == Location::Inner) {
+        for (auto it = begin; it != end; ++it) {
+            (*it)->value = Location::Inner;
+        }
+        return;
+    }
+
+    if ((max - min).maxCoeff() < LEAF_BLOCK_SIZE) {
+        for (auto it = begin; it != end; ++it) {
+            partVoxels->push_back(*it);
+            for (size_t i = 0; i < DIMS; ++i) {
+                (*corners)[i].push_back((*it)->coordinates()[i]);
+            }
+        }
+        return;
+    }
+
+    splitBlock(halfspaces, 0, min, max, begin, end, partVoxels, corners);
 }
 
+} // namespace
+
 void rasterizePartByHalfspaces(
         const MinkowskiSum::ConvexPart& convexPart,
         Sampling<Location>* partSampling)
 {
-    partSampling->voxels().process([] (auto& voxel) {
-        voxel.value = Location::Inner;
+    // Voxels apart from the part bounding box are left outer as they are.
+    // The halfspaces alone may find some of them boundary near the part
+    // corners, so the image is tighter there than the one classifying
+    // every voxel, still conservative as those miss the part.
+    const auto localBBox = partSampling->toLocal(convexPart.boundingBox);
+    std::vector<Voxel<Location>*> partVoxels;
+    VoxelCorners corners;
+    overlappingVoxels(partSampling, localBBox).process([&] (auto& voxel) {
+        partVoxels.push_back(&voxel);
+        for (size_t i = 0; i < DIMS; ++i) {
+            corners[i].push_back(voxel.coordinates()[i]);
+        }
     });
+    if (partVoxels.empty()) {
+        return;
+    }
 
-    const auto baseFacet = partSampling->toLocal(convexPart.baseFacet);
-    partSampling->toLocal(convexPart.facets).process(
-                [&] (const auto& localFacet) {
-        auto halfspace = outsideOrientedHalfspace(
-            localFacet, baseFacet, convexPart.innerDirection);
+    std::vector<Location> locations(partVoxels.size());
+    classifyVoxels(
+        localHalfspaces(convexPart, *partSampling), corners, locations.data());
+    for (size_t i = 0; i < partVoxels.size(); ++i) {
+        partVoxels[i]->value = locations[i];
+    }
+}
 
-        // Voxels are unit cubes in local coordinates
-        const auto lowestPoint = FacetBoxOverlap::lowestPoint(
-            Vector<>::Constant(1.), halfspace.normal);
-        const double voxelSizeProjection = halfspace.normal.cwiseAbs().sum();
-
-        partSampling->voxels().process([&] (Voxel<Location>& voxel) {
-            double signedPlaneDistance = halfspace.normal.dot(
-                voxel.coordinates().cast<double>() + lowestPoint)
-                    - halfspace.planeOffset;
-
-            auto& value = voxel.value;
-            if (signedPlaneDistance > MEPS) {
-                value = Location::Outer;
-            } else if (signedPlaneDistance + voxelSizeProjection > -MEPS &&
-                    value != Location::Outer) {
-                value = Location::Boundary;
-            }
-        });
+void rasterizePartByBlocks(
+        const MinkowskiSum::ConvexPart& convexPart,
+        Sampling<Location>* partSampling)
+{
+    // Voxels apart from the part bounding box are left outer as they are.
+    // The halfspaces alone may find some of them boundary near the part
+    // corners, so the image is tighter there than the one classifying
+    // every voxel, still conservative as those miss the part.
+    const auto localBBox = partSampling->toLocal(convexPart.boundingBox);
+    std::vector<Voxel<Location>*> blockVoxels;
+    auto min = Coordinates::constant(std::numeric_limits<int>::max());
+    auto max = Coordinates::constant(std::numeric_limits<int>::min());
+    overlappingVoxels(partSampling, localBBox).process([&] (auto& voxel) {
+        blockVoxels.push_back(&voxel);
+        min = min.cwiseMin(voxel.coordinates()).eval();
+        max = max.cwiseMax(voxel.coordinates()).eval();
     });
+    if (blockVoxels.empty()) {
+        return;
+    }
+
+    // Blocks start with the box of the voxels
+    const auto halfspaces = localHalfspaces(convexPart, *partSampling);
+    std::vector<Voxel<Location>*> partVoxels;
+    VoxelCorners corners;
+    rasterizeBlock(
+        halfspaces,
+        min,
+        max,
+        blockVoxels.begin(),
+        blockVoxels.end(),
+        &partVoxels,
+        &corners);
+
+    std::vector<Location> locations(partVoxels.size());
+    classifyVoxels(halfspaces, corners, locations.data());
+    for (size_t i = 0; i < partVoxels.size(); ++i) {
+        partVoxels[i]->value = locations[i];
+    }
 }
@@ -15,3 +15,12 @@
 void rasterizePartByHalfspaces(
         const MinkowskiSum::ConvexPart& convexPart,
         Sampling<Location>* partSampling);
+
+// Same image as by halfspaces, but blocks of the voxels are tested
+// against the halfspaces first, starting with the box of all of them.
+// Blocks outside one of the halfspaces are skipped and the ones inside
+// all are drawn inner at once, only the rest are halved down to the
+// voxel tests. So the tests follow the part surface, not its volume.
+void rasterizePartByBlocks(
+        const MinkowskiSum::ConvexPart& convexPart,
+        Sampling<Location>* partSampling);
@@ -7,23 +7,40 @@
 
 #include "minkowski_sum.h"
 
-#include "geometry/entity/perpendicular.h"
 #include "geometry/utility/cgal.h"
 #include "helper/stats.h"
 
 #include <CGAL/Triangulation.h>
+#include <Eigen/Dense>
 
+#include <algorithm>
+#include <cmath>
+#include <iterator>
+#include <limits>
 #include <unordered_map>
 #include <utility>
 
 namespace {
 
+std::vector<Facet> collect(const Generator<const Facet&>& facets)
+{
+    std::vector<Facet> result;
+    facets.process([&] (const Facet& facet) {
+        result.push_back(facet);
+    });
+    return result;
+}
+
 } // namespace
 
 MinkowskiSum::MinkowskiSum(
         const Polytope& contour,
         const ConvexDecomposition& patternDecomposition)
-    : partTemplates_(prepareTemplates(contour, patternDecomposition))
+    : contourFacets_(collect(contour.facetGeometries()))
+    , partTemplates_(prepareTemplates(contour, patternDecomposition))
+    , partsTree_(buildPartsTree(partTemplates_))
+    , patternParts_(extractPatternParts(
+        partTemplates_, contourFacets_.size()))
 {}
 
 Generator<const MinkowskiSum::ConvexPart&> MinkowskiSum::convexParts(
@@ -31,33 +48,73 @@ Generator<const MinkowskiSum::ConvexPart&> MinkowskiSum::convexParts(
 {
     assert(patternScale > MEPS);
     return Generator<const ConvexPart&>([this, patternScale] (auto&& yield) {
-        const auto extractPart = [this, patternScale]
-                (const ConvexPartTemplate* partTemplate) {
-            return Generator<const Facet&>(
-                    [patternScale, partTemplate] (auto&& yield) {
-                for (const auto& facetTemplate : partTemplate->facets) {
-                    Facet facet;
-                    for (size_t i = 0; i < facet.size(); ++i) {
-                        const auto& vertexTemplate = facetTemplate[i];
-                        facet[i] = (vertexTemplate.origin +
-                            patternScale * vertexTemplate.direction).eval();
-                    }
-                    yield(facet);
-                }
-            });
-        };
+        for (size_t i = 0; i < partTemplates_.size(); ++i) {
+            yield(convexPart(i, patternScale));
+        }
+    });
+}
 
-        for (const auto& partTemplate : partTemplates_) {
-            assert(!partTemplate.facets.empty());
-            yield(ConvexPart{
-                extractPart(&partTemplate),
-                partTemplate.baseFacet,
-                findInnerDirection(partTemplate)
-            });
+Generator<const MinkowskiSum::ConvexPart&> MinkowskiSum::convexParts(
+        double patternScale,
+        const BoundingBox& region) const
+{
+    assert(patternScale > MEPS);
+    return Generator<const ConvexPart&>([
+            this,
+            patternScale,
+            partIndices = convexPartIndices(
+                region, patternScale, patternScale)] (auto&& yield) {
+        for (const auto partIndex : partIndices) {
+            yield(convexPart(partIndex, patternScale));
         }
     });
 }
 
+MinkowskiSum::ConvexPart MinkowskiSum::convexPart(
+        size_t partIndex,
+        double patternScale) const
+{
+    assert(patternScale > MEPS);
+    assert(partIndex < partTemplates_.size());
+    const auto* partTemplate = &partTemplates_[partIndex];
+    assert(!partTemplate->facets.empty());
+
+    auto min = Point::constant(std::numeric_limits<double>::infinity());
+    auto max = Point::constant(-std::numeric_limits<double>::infinity());
+    for (const auto& vertexTemplate : partTemplate->vertices) {
+        const auto vertex = (vertexTemplate.origin +
+            patternScale * vertexTemplate.direction).eval();
+        min = min.cwiseMin(vertex).eval();
+        max = max.cwiseMax(vertex).eval();
+    }
+
+    return ConvexPart{
+        Generator<const Facet&>([patternScale, partTemplate] (auto&& yield) {
+            for (const auto& facetTemplate : partTemplate->facets) {
+                Facet facet;
+                for (size_t i = 0; i < facet.size(); ++i) {
+                    const auto& vertexTemplate = facetTemplate[i];
+                    facet[i] = (vertexTemplate.origin +
+                        patternScale * vertexTemplate.direction).eval();
+                }
+                yield(facet);
+            }
+        }),
+        partTemplate->halfspaces,
+        patternScale,
+        BoundingBox{min, max}
+    };
+}
+
+std::vector<size_t> MinkowskiSum::convexPartIndices(
+        const BoundingBox& region,
+        double minScale,
+        double maxScale) const
+{
+    assert(minScale > MEPS);
+    return partsTree_.intersecting(region, minScale, maxScale);
+}
+
 std::vector<MinkowskiSum::ConvexPartTemplate>
 MinkowskiSum::prepareTemplates(
         const Polytope& contour,
@@ -87,11 +144,14 @@ MinkowskiSum::ConvexPartTemplate MinkowskiSum::convexSum(
 
     std::unordered_map<Triangulation::Vertex_handle, VertexTemplate>
         vertexTemplates;
+    // The part is a convex hull of these at any scale
+    std::vector<VertexTemplate> vertices;
     for (const auto& fixedVertex : contourFacet) {
         for (const auto& scalingVertex : patternPart) {
             const auto handle = triangulation.insert(
                 toCGAL(Point(fixedVertex + scalingVertex)));
             vertexTemplates[handle] = {fixedVertex, scalingVertex};
+            vertices.push_back({fixedVertex, scalingVertex});
         }
     }
 
@@ -119,24 +179,144 @@ MinkowskiSum::ConvexPartTemplate MinkowskiSum::convexSum(
         facets.push_back(std::move(resultFacet));
     }
 
+    auto halfspaces = buildHalfspaces(facets, vertices);
     return ConvexPartTemplate{
         std::move(facets),
-        contourFacet
+        std::move(vertices),
+        std::move(halfspaces)
     };
 }
 
-Vector<> MinkowskiSum::findInnerDirection(
-        const MinkowskiSum::ConvexPartTemplate& partTemplate)
+// The facet normal is a quadratic polynomial of the pattern scale with all
+// the coefficients parallel to each other, see buildHalfspaces().
+// The largest one is used as the facet may degenerate at some scales.
+Vector<> MinkowskiSum::templateNormal(const FacetTemplate& facetTemplate)
 {
-    auto baseNormal = unitNormal(partTemplate.baseFacet);
-    for (const auto& facetTemplate : partTemplate.facets) {
-        for (const auto& vertexTemplate : facetTemplate) {
-            if (std::fabs(vertexTemplate.direction.dot(baseNormal)) > MEPS) {
-                return vertexTemplate.direction;
-            }
+    assert(DIMS == 3);
+    const auto& base = facetTemplate[0];
+    const Vector<> fixedEdges[2] = {
+        facetTemplate[1].origin - base.origin,
+        facetTemplate[2].origin - base.origin
+    };
+    const Vector<> scalingEdges[2] = {
+        facetTemplate[1].direction - base.direction,
+        facetTemplate[2].direction - base.direction
+    };
+
+    const Vector<> coefficients[3] = {
+        fixedEdges[0].cross(fixedEdges[1]),
+        fixedEdges[0].cross(scalingEdges[1]) +
+            scalingEdges[0].cross(fixedEdges[1]),
+        scalingEdges[0].cross(scalingEdges[1])
+    };
+    const auto* result = std::max_element(
+        std::begin(coefficients), std::end(coefficients),
+        [] (const Vector<>& lhs, const Vector<>& rhs) {
+            return lhs.squaredNorm() < rhs.squaredNorm();
+        });
+    assert(result->norm() > MEPS);
+    return result->normalized();
+}
+
+// Faces of the sum are the sums of the faces of its terms,
+// so scaling the pattern keeps every facet plane parallel to itself
+// and moves it along the normal linearly.
+MinkowskiSum::HalfspaceTable MinkowskiSum::buildHalfspaces(
+        const std::vector<FacetTemplate>& facets,
+        const std::vector<VertexTemplate>& vertices)
+{
+    assert(!vertices.empty());
+    // Strictly inner point for the unit scale
+    auto innerPoint = Point::constant(0.);
+    for (const auto& vertexTemplate : vertices) {
+        innerPoint += vertexTemplate.origin + vertexTemplate.direction;
+    }
+    innerPoint /= static_cast<double>(vertices.size());
+
+    HalfspaceTable result;
+    for (auto& normals : result.normals) {
+        normals.reserve(facets.size());
+    }
+    result.offsets0.reserve(facets.size());
+    result.offsetSlopes.reserve(facets.size());
+
+    for (const auto& facetTemplate : facets) {
+        auto normal = templateNormal(facetTemplate);
+        double offset0 = normal.dot(facetTemplate[0].origin);
+        double offsetSlope = normal.dot(facetTemplate[0].direction);
+
+        const double innerOffset =
+            normal.dot(innerPoint) - offset0 - offsetSlope;
+        assert(std::fabs(innerOffset) > MEPS);
+        if (innerOffset > 0.) {
+            normal = -normal;
+            offset0 = -offset0;
+            offsetSlope = -offsetSlope;
         }
+
+        for (size_t i = 0; i < DIMS; ++i) {
+            result.normals[i].push_back(normal[i]);
+        }
+        result.offsets0.push_back(offset0);
+        result.offsetSlopes.push_back(offsetSlope);
     }
-    // Non-degenerate patterns never reach here
-    assert(false);
-    return partTemplate.facets[0][0].direction;
+
+    return result;
+}
+
+ScalingBoxTree MinkowskiSum::buildPartsTree(
+        const std::vector<ConvexPartTemplate>& partTemplates)
+{
+    std::vector<ScalingBox> boxes;
+    boxes.reserve(partTemplates.size());
+    for (const auto& partTemplate : partTemplates) {
+        assert(!partTemplate.vertices.empty());
+        const auto& first = partTemplate.vertices.front();
+        ScalingBox box{
+            first.origin, first.origin,
+            first.direction, first.direction
+        };
+        for (const auto& vertexTemplate : partTemplate.vertices) {
+            box.originMin = box.originMin.cwiseMin(
+                vertexTemplate.origin).eval();
+            box.originMax = box.originMax.cwiseMax(
+                vertexTemplate.origin).eval();
+            box.directionMin = box.directionMin.cwiseMin(
+                vertexTemplate.direction).eval();
+            box.directionMax = box.directionMax.cwiseMax(
+                vertexTemplate.direction).eval();
+        }
+        boxes.push_back(std::move(box));
+    }
+    return ScalingBoxTree(std::move(boxes));
+}
+
+// Every facet of the sum is a sum of the faces of the terms in the direction
+// of its normal, so the offset slope is the support value of the pattern
+// part. The facets normal to the pattern part ones are there as well,
+// hence the halfspaces of any part built with a pattern part bound it.
+std::vector<MinkowskiSum::PatternPart> MinkowskiSum::extractPatternParts(
+        const std::vector<ConvexPartTemplate>& partTemplates,
+        size_t contourFacetsCount)
+{
+    assert(partTemplates.empty() || contourFacetsCount > 0);
+    std::vector<PatternPart> result;
+    // Parts go pattern part by pattern part, see prepareTemplates()
+    for (size_t i = 0; i < partTemplates.size(); i += contourFacetsCount) {
+        const auto& partTemplate = partTemplates[i];
+        PatternPart patternPart{partTemplate.halfspaces, {}};
+        std::fill(
+            patternPart.halfspaces.offsets0.begin(),
+            patternPart.halfspaces.offsets0.end(),
+            0.);
+
+        // Vertices go contour vertex by contour vertex, see convexSum()
+        const size_t verticesCount = partTemplate.vertices.size() / DIMS;
+        for (size_t j = 0; j < verticesCount; ++j) {
+            patternPart.vertices.push_back(
+                partTemplate.vertices[j].direction);
+        }
+        result.push_back(std::move(patternPart));
+    }
+    return result;
 }
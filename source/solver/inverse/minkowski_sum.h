@@ -8,32 +8,61 @@
 #pragma once
 
 #include "geometry/convex_decomposition/convex_decomposition.h"
+#include "geometry/entity/bounding_box.h"
 #include "geometry/entity/polytope.h"
 #include "geometry/kernel.h"
+#include "solver/inverse/scaling_box_tree.h"
 #include "utility/generator.h"
 #include "utility/noncopyable.h"
 
+#include <array>
 #include <utility>
+#include <vector>
 
 class MinkowskiSum final : public NonCopyable {
 public:
+    // Bounding planes of a convex part packed as a structure of arrays.
+    // Normals do not depend on the pattern scale and are oriented outside,
+    // for the inner points of the part at a given scale
+    //     normal.dot(point) <= offset0 + patternScale * offsetSlope
+    struct HalfspaceTable final {
+        size_t size() const
+        {
+            return offsets0.size();
+        }
+
+        std::array<std::vector<double>, DIMS> normals;
+        std::vector<double> offsets0;
+        std::vector<double> offsetSlopes;
+    };
+
     struct ConvexPart final : public NonCopyable {
         template<class FacetsSource>
         ConvexPart(
                 FacetsSource&& source,
-                Facet baseFacet,
-                Vector<> innerDirection)
+                const HalfspaceTable& halfspaces,
+                double patternScale,
+                BoundingBox boundingBox)
             : facets(std::forward<FacetsSource>(source))
-            , baseFacet(std::move(baseFacet))
-            , innerDirection(std::move(innerDirection))
+            , halfspaces(halfspaces)
+            , patternScale(patternScale)
+            , boundingBox(std::move(boundingBox))
         {}
 
         const Generator<const Facet&> facets;
 
-        // For the determination of the inner region
-        const Facet baseFacet;
-        // For the baseFacet itself
-        const Vector<> innerDirection;
+        // The same part described by its bounding planes
+        const HalfspaceTable& halfspaces;
+        const double patternScale;
+
+        const BoundingBox boundingBox;
+    };
+
+    // Convex part of the pattern scaled about the pattern origin,
+    // the offsets0 of its halfspaces are zero
+    struct PatternPart final {
+        HalfspaceTable halfspaces;
+        std::vector<Vector<>> vertices;
     };
 
     MinkowskiSum(
@@ -42,6 +71,33 @@ public:
 
     // patternScale must be strictly positive
     Generator<const ConvexPart&> convexParts(double patternScale) const;
+    // Only the parts possibly intersecting the region
+    Generator<const ConvexPart&> convexParts(
+            double patternScale,
+            const BoundingBox& region) const;
+
+    // Random access to the parts for splitting them between threads
+    size_t convexPartsCount() const
+    {
+        return partTemplates_.size();
+    }
+    ConvexPart convexPart(size_t partIndex, double patternScale) const;
+    // Indices of the parts possibly intersecting the region
+    // at some scale within [minScale, maxScale] in increasing order
+    std::vector<size_t> convexPartIndices(
+            const BoundingBox& region,
+            double minScale,
+            double maxScale) const;
+
+    // Terms of the sum for the rasterizers working on them directly
+    const std::vector<Facet>& contourFacets() const
+    {
+        return contourFacets_;
+    }
+    const std::vector<PatternPart>& patternParts() const
+    {
+        return patternParts_;
+    }
 
 private:
     struct VertexTemplate {
@@ -51,7 +107,8 @@ private:
     using FacetTemplate = std::array<VertexTemplate, DIMS>;
     struct ConvexPartTemplate {
         std::vector<FacetTemplate> facets;
-        Facet baseFacet;
+        std::vector<VertexTemplate> vertices;
+        HalfspaceTable halfspaces;
     };
 
     static std::vector<ConvexPartTemplate> prepareTemplates(
@@ -60,7 +117,19 @@ private:
     static ConvexPartTemplate convexSum(
             const Facet& contourFacet,
             const PolytopeConvexPart& patternPart);
-    static Vector<> findInnerDirection(const ConvexPartTemplate& partTemplate);
+    static Vector<> templateNormal(const FacetTemplate& facetTemplate);
+    static HalfspaceTable buildHalfspaces(
+            const std::vector<FacetTemplate>& facets,
+            const std::vector<VertexTemplate>& vertices);
+    static ScalingBoxTree buildPartsTree(
+            const std::vector<ConvexPartTemplate>& partTemplates);
+    static std::vector<PatternPart> extractPatternParts(
+            const std::vector<ConvexPartTemplate>& partTemplates,
+            size_t contourFacetsCount);
 
+    const std::vector<Facet> contourFacets_;
     const std::vector<ConvexPartTemplate> partTemplates_;
+    // Parts bounds for any pattern scale
+    const ScalingBoxTree partsTree_;
+    const std::vector<PatternPart> patternParts_;
 };
@@ -7,23 +7,265 @@
 
 #include "minkowski_sum_rasterizer.h"
 
+#include "grid/sampling/box_raster_view.h"
+#include "grid/sampling/location_planes.h"
+#include "grid/sampling/raster_pool.h"
+#include "grid/sampling/sampling_view.h"
+
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <vector>
+
+namespace {
+
+bool notInner(Location value)
+{
+    return value != Location::Inner;
+}
+
+// Pairwise reduction of the images into the first one
+// by combine(const Image& source, Image* target)
+template<class Image, class Combine>
+void reduceImages(
+        WorkStealingPool* pool,
+        const std::vector<Image*>& images,
+        const Combine& combine)
+{
+    for (size_t stride = 1; stride < images.size(); stride *= 2) {
+        pool->run(
+            (images.size() + 2 * stride - 1) / (2 * stride),
+            [&] (size_t /*workerIndex*/, size_t pairIndex) {
+                const auto target = pairIndex * 2 * stride;
+                if (target + stride < images.size()) {
+                    combine(*images[target + stride], images[target]);
+                }
+            });
+    }
+}
+
+// Gives the voxels of the view back to the pool
+void releaseView(
+        RasterPool<Location>* pool,
+        std::optional<SamplingView<Location>>* view)
+{
+    if (*view) {
+        recycleStorage(pool, &**view);
+        view->reset();
+    }
+}
+
+// Image of the parts taken by a worker over the voxels not inner yet,
+// made once the worker takes its first part. The views take
+// their voxels from the pool of the worker.
+struct PartialImage final {
+    void release()
+    {
+        releaseView(&pool, &partSampling);
+        releaseView(&pool, &image);
+    }
+
+    RasterPool<Location> pool;
+    std::optional<SamplingView<Location>> image;
+    std::optional<SamplingView<Location>> partSampling;
+};
+
+// Workers are kept running between the rasterizations,
+// the images and the planes are kept with their storages
+struct ParallelRasterization final {
+    explicit ParallelRasterization(size_t workersCount)
+        : pool(workersCount)
+        , partialImages(pool.workersCount())
+    {}
+
+    // One rasterization at a time
+    std::mutex mutex;
+    WorkStealingPool pool;
+    std::vector<PartialImage> partialImages;
+    std::vector<SamplingView<Location>*> images;
+    std::vector<LocationPlanes> planes;
+    std::vector<LocationPlanes*> reducedPlanes;
+};
+
+// Storages of the views made by the sequential rasterizer
+struct SequentialRasterization final {
+    std::mutex mutex;
+    RasterPool<Location> pool;
+};
+
+} // namespace
+
+BoundingBox imageRegion(const Mapper& sampling)
+{
+    const auto& container = sampling.container();
+    const double radius = container.radius() + sampling.gridStep();
+    return {
+        (container.center() - Point::constant(radius)).eval(),
+        (container.center() + Point::constant(radius)).eval()
+    };
+}
+
 void combineImages(
         const SparseRaster<Location>& partImage,
         SparseRaster<Location>* combinedImage)
 {
-    partImage.voxels().process([&] (const auto& voxel) {
-        auto* unitedVoxel = combinedImage->find(voxel.coordinates());
-        assert(unitedVoxel);
-        auto& unitedValue = unitedVoxel->value;
-
-        // Skip already inner voxels
-        if (unitedValue == Location::Outer) {
-            unitedValue = voxel.value;
-        } else if (unitedValue == Location::Boundary &&
-                   voxel.value == Location::Inner) {
-            unitedValue = Location::Inner;
+    joinVoxels(
+        partImage.voxels(),
+        combinedImage->voxels(),
+        Coordinates::constant(0),
+        [] (const auto& voxel, auto* unitedVoxel) {
+            assert(unitedVoxel);
+            combineLocations(&unitedVoxel->value, voxel.value);
+        });
+}
+
+MinkowskiSumRasterizer decomposingMSRasterizer(
+        ConvexPartRasterizer convexPartRasterizer)
+{
+    return [
+            convexPartRasterizer = std::move(convexPartRasterizer),
+            rasterization = std::make_shared<SequentialRasterization>()] (
+            const MinkowskiSum& minkowskiSum,
+            double patternScale,
+            Sampling<Location>* sampling)
+    {
+        // Rasterizations running at once by the copies of the rasterizer
+        // take new storages
+        std::unique_lock<std::mutex> lock(
+            rasterization->mutex, std::try_to_lock);
+        auto* pool = lock ? &rasterization->pool : nullptr;
+        SamplingView<Location> partSampling(
+            sampling, notInner, Location::Outer, pool);
+
+        const auto partIndices = minkowskiSum.convexPartIndices(
+            imageRegion(*sampling), patternScale, patternScale);
+        for (const auto partIndex : partIndices) {
+            // The view only keeps the voxels not inner yet
+            if (partSampling.size() == 0) {
+                break;
+            }
+
+            partSampling.fill(Location::Outer);
+            convexPartRasterizer(
+                minkowskiSum.convexPart(partIndex, patternScale),
+                &partSampling);
+            partSampling.commit(combineLocations);
         }
-    });
+        recycleStorage(pool, &partSampling);
+    };
+}
+
+MinkowskiSumRasterizer parallelDecomposingMSRasterizer(
+        ConvexPartRasterizer convexPartRasterizer,
+        size_t workersCount)
+{
+    return [
+            convexPartRasterizer = std::move(convexPartRasterizer),
+            rasterization =
+                std::make_shared<ParallelRasterization>(workersCount)] (
+            const MinkowskiSum& minkowskiSum,
+            double patternScale,
+            Sampling<Location>* sampling)
+    {
+        std::lock_guard<std::mutex> lock(rasterization->mutex);
+        auto& partialImages = rasterization->partialImages;
+        // Left by a rasterization failed in the middle
+        for (auto& partialImage : partialImages) {
+            partialImage.release();
+        }
+
+        const auto partIndices = minkowskiSum.convexPartIndices(
+            imageRegion(*sampling), patternScale, patternScale);
+        // Set once a partial image is inner everywhere, so is the union
+        std::atomic<bool> saturated{false};
+        rasterization->pool.run(
+            partIndices.size(),
+            [&] (size_t workerIndex, size_t index) {
+                if (saturated.load(std::memory_order_relaxed)) {
+                    return;
+                }
+
+                // Workers not given any part allocate nothing
+                auto& partialImage = partialImages[workerIndex];
+                if (!partialImage.image) {
+                    partialImage.image.emplace(
+                        sampling,
+                        notInner,
+                        Location::Outer,
+                        &partialImage.pool);
+                    partialImage.partSampling.emplace(
+                        &*partialImage.image,
+                        notInner,
+                        Location::Outer,
+                        &partialImage.pool);
+                }
+
+                auto& partSampling = *partialImage.partSampling;
+                partSampling.fill(Location::Outer);
+                convexPartRasterizer(
+                    minkowskiSum.convexPart(partIndices[index], patternScale),
+                    &partSampling);
+                partSampling.commit(combineLocations);
+
+                if (partSampling.size() == 0) {
+                    saturated.store(true, std::memory_order_relaxed);
+                }
+            });
+
+        auto& images = rasterization->images;
+        images.clear();
+        for (auto& partialImage : partialImages) {
+            if (partialImage.image) {
+                releaseView(&partialImage.pool, &partialImage.partSampling);
+                images.push_back(&*partialImage.image);
+            }
+        }
+
+        // Dense images of a well occupied box are united word by word
+        const auto denseBox = images.empty() ?
+            std::nullopt : LocationPlanes::preferableBox(*images.front());
+        if (denseBox) {
+            auto& planes = rasterization->planes;
+            auto& reducedPlanes = rasterization->reducedPlanes;
+            for (size_t i = 0; i < images.size(); ++i) {
+                if (i < planes.size()) {
+                    planes[i].reset(denseBox->first, denseBox->second);
+                } else {
+                    planes.emplace_back(denseBox->first, denseBox->second);
+                }
+            }
+            reducedPlanes.clear();
+            for (size_t i = 0; i < images.size(); ++i) {
+                reducedPlanes.push_back(&planes[i]);
+            }
+            rasterization->pool.run(
+                images.size(),
+                [&] (size_t /*workerIndex*/, size_t imageIndex) {
+                    planes[imageIndex].assign(*images[imageIndex]);
+                });
+            reduceImages(
+                &rasterization->pool,
+                reducedPlanes,
+                [] (const auto& source, auto* target) {
+                    target->unite(source);
+                });
+            planes.front().commit(sampling, combineLocations);
+        } else if (!images.empty()) {
+            reduceImages(
+                &rasterization->pool,
+                images,
+                [] (const auto& source, auto* target) {
+                    combineImages(source, target);
+                });
+            // The images are views of the sampling voxels
+            images.front()->commit(combineLocations);
+        }
+
+        for (auto& partialImage : partialImages) {
+            partialImage.release();
+        }
+    };
 }
 
 ConvexPartRasterizer polytopePartRasterizer(
@@ -33,8 +275,12 @@ ConvexPartRasterizer polytopePartRasterizer(
             const MinkowskiSum::ConvexPart& convexPart,
             Sampling<Location>* partSampling) {
         assert(polytopeRasterizer);
+        // Voxels apart from the part bounding box are left outer as they are
+        BoxRasterView<Location> partView(
+            partSampling,
+            partSampling->toLocal(convexPart.boundingBox));
         polytopeRasterizer(
             partSampling->toLocal(convexPart.facets),
-            partSampling);
+            &partView);
     };
 }
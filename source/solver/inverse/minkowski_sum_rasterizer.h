@@ -13,6 +13,7 @@
 #include "grid/sampling/sampling.h"
 #include "grid/sampling/sparse_raster.h"
 #include "utility/generator.h"
+#include "utility/work_stealing_pool.h"
 
 #include <functional>
 
@@ -22,46 +23,52 @@ using MinkowskiSumRasterizer = std::function<void(
     double patternScale,
     Sampling<Location>* sampling)>;
 
-// Assumes partSampling to be empty (all voxels outer)
+// Assumes partSampling to be empty (all voxels outer).
+// Parts may be rasterized on worker threads, see
+// parallelDecomposingMSRasterizer(), so no samplings reporting
+// statistics are to be made there.
 using ConvexPartRasterizer = std::function<void(
     const MinkowskiSum::ConvexPart& convexPart,
     Sampling<Location>* partSampling)>;
 
+// Location of a voxel in a union of images
+inline void combineLocations(Location* unitedValue, Location partValue)
+{
+    // Skip already inner voxels
+    if (*unitedValue == Location::Outer) {
+        *unitedValue = partValue;
+    } else if (*unitedValue == Location::Boundary &&
+               partValue == Location::Inner) {
+        *unitedValue = Location::Inner;
+    }
+}
+
+// Global bounds of the sampling container with a margin of a voxel,
+// the parts apart from those do not change the image
+BoundingBox imageRegion(const Mapper& sampling);
+
 void combineImages(
         const SparseRaster<Location>& partImage,
         SparseRaster<Location>* combinedImage);
 
-template<template<class> class PartSampling>
+// Parts are rasterized one by one into a single view of the sampling
+// restricted to the voxels not yet inner for the combined image.
+// Parts missing the sampling container are skipped and the rest
+// are dropped as soon as every voxel is inner.
 MinkowskiSumRasterizer decomposingMSRasterizer(
-        ConvexPartRasterizer convexPartRasterizer)
-{
-    return [convexPartRasterizer = std::move(convexPartRasterizer)] (
-            const MinkowskiSum& minkowskiSum,
-            double patternScale,
-            Sampling<Location>* sampling)
-    {
-        minkowskiSum.convexParts(patternScale).process(
-            [&] (const MinkowskiSum::ConvexPart& convexPart) {
-                PartSampling<Location> partSampling{
-                    *sampling,
-                    typename PartSampling<Location>::Raster{
-                        compositeGenerator<const Coordinates&>(
-                            sampling->voxels(),
-                            [] (const auto& voxel, auto&& yield) {
-                                if (voxel.value != Location::Inner) {
-                                    yield(voxel.coordinates());
-                                }
-                            }),
-                        Location::Outer,
-                        sampling->size()
-                    }
-                };
+        ConvexPartRasterizer convexPartRasterizer);
 
-                convexPartRasterizer(convexPart, &partSampling);
-                combineImages(partSampling, sampling);
-            });
-    };
-}
+// Spreads the convex parts over the threads of a work-stealing pool.
+// Every worker taking parts accumulates a partial image of its own and
+// those are reduced at the end. Since combining images is commutative
+// the result is exactly the same as for the sequential rasterizer.
+// Workers skip the parts left once a partial image is inner everywhere.
+// Partial images of a well occupied box are reduced as dense bit-planes.
+// The pool threads live as long as the rasterizer and its copies,
+// those share them and rasterize one at a time.
+MinkowskiSumRasterizer parallelDecomposingMSRasterizer(
+        ConvexPartRasterizer convexPartRasterizer,
+        size_t workersCount = WorkStealingPool::defaultWorkersCount());
 
 ConvexPartRasterizer polytopePartRasterizer(
         PolytopeRasterizer polytopeRasterizer);
@@ -0,0 +1,508 @@
+// This file is part of xdscribe
+//
+// Copyright (C) 2019 Sergey Karpukhin <contact@kserz.rocks>
+//
+// Licensed under GNU General Public License version 3.
+// Full license text is available in LICENSE file.
+
+#include "morphology_ms_rasterizer.h"
+
+#include "geometry/entity/bounding_box.h"
+#include "grid/rasterization/facet_box_overlap.h"
+#include "grid/rasterization/facet_rasterizer.h"
+#include "grid/sampling/vector_sampling.h"
+#include "grid/sampling/vector_sparse_raster.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include <memory>
+#include <optional>
+#include <utility>
+#include <vector>
+
+namespace {
+
+constexpr int WORD_BITS = 64;
+
+// Boundary voxels are only known to be within the overlap tolerance
+// of the contour, so the inner neighbourhoods are extended by this
+constexpr double NEIGHBOURHOOD_MARGIN = 1e-6;
+
+// Offsets from a boundary voxel to the image ones, those are
+// (dx, dy, z) for every z within [zMin, zMax]
+struct Segment final {
+    int dx;
+    int dy;
+    int zMin;
+    int zMax;
+};
+
+// Bounds of the offsets d with the neighbourhood d + [-1, 1]^DIMS meeting
+// the part scaled into local coordinates
+std::pair<Point, Point> offsetBounds(
+        const MinkowskiSum::PatternPart& part,
+        double localScale)
+{
+    auto min = Point::constant(std::numeric_limits<double>::infinity());
+    auto max = Point::constant(-std::numeric_limits<double>::infinity());
+    for (const auto& vertex : part.vertices) {
+        const Point localVertex = (localScale * vertex).eval();
+        min = min.cwiseMin(localVertex).eval();
+        max = max.cwiseMax(localVertex).eval();
+    }
+    return {
+        (min - Point::constant(1. + MEPS)).eval(),
+        (max + Point::constant(1. + MEPS)).eval()
+    };
+}
+
+// Offsets d within the bounds such that the part scaled into local
+// coordinates meets the neighbourhood d + [-1, 1]^DIMS for touching
+// or covers it for inner. For the touching ones every halfspace is only
+// moved by the neighbourhood, so some offsets near the part edges are extra.
+void appendSegments(
+        const MinkowskiSum::PatternPart& part,
+        double localScale,
+        const std::pair<Point, Point>& bounds,
+        bool inner,
+        std::vector<Segment>* segments)
+{
+    assert(DIMS == 3);
+    const auto& [min, max] = bounds;
+    const auto& halfspaces = part.halfspaces;
+    std::vector<double> planeBounds;
+    planeBounds.reserve(halfspaces.size());
+    for (size_t j = 0; j < halfspaces.size(); ++j) {
+        double sizeProjection = 0.;
+        for (size_t i = 0; i < DIMS; ++i) {
+            sizeProjection += std::fabs(halfspaces.normals[i][j]);
+        }
+        const double offset = localScale * halfspaces.offsetSlopes[j];
+        planeBounds.push_back(inner ?
+            offset - (1. + NEIGHBOURHOOD_MARGIN) * sizeProjection :
+            offset + sizeProjection + MEPS);
+    }
+
+    const auto& normals = halfspaces.normals;
+    for (int dx = static_cast<int>(std::ceil(min[0]));
+            dx <= static_cast<int>(std::floor(max[0])); ++dx) {
+        for (int dy = static_cast<int>(std::ceil(min[1]));
+                dy <= static_cast<int>(std::floor(max[1])); ++dy) {
+            // normal.dot(d) <= bound restricts the last coordinate alone
+            double zMin = min[2];
+            double zMax = max[2];
+            for (size_t j = 0; j < halfspaces.size() && zMin <= zMax; ++j) {
+                const double rest = planeBounds[j] -
+                    normals[0][j] * dx - normals[1][j] * dy;
+                if (normals[2][j] > 0.) {
+                    zMax = std::min(zMax, rest / normals[2][j]);
+                } else if (normals[2][j] < 0.) {
+                    zMin = std::max(zMin, rest / normals[2][j]);
+                } else if (rest < 0.) {
+                    zMax = -std::numeric_limits<double>::infinity();
+                }
+            }
+
+            if (zMin <= zMax) {
+                const Segment segment{
+                    dx, dy,
+                    static_cast<int>(std::ceil(zMin)),
+                    static_cast<int>(std::floor(zMax))
+                };
+                if (segment.zMin <= segment.zMax) {
+                    segments->push_back(segment);
+                }
+            }
+        }
+    }
+}
+
+// Dense set of voxels within a box, bounds are included.
+// Every row along the last axis starts with a new word.
+class BoundaryRows final {
+public:
+    BoundaryRows(Coordinates min, Coordinates max)
+        : min_(std::move(min))
+        , max_(std::move(max))
+        , size_((max_ - min_ + Coordinates::constant(1)).eval())
+        , rowWords_((size_[2] + WORD_BITS - 1) / WORD_BITS)
+        , words_(rowWords_ * size_[0] * size_[1], 0)
+        , nonEmpty_(size_[0] * size_[1], false)
+    {
+        assert(DIMS == 3);
+    }
+
+    const Coordinates& min() const
+    {
+        return min_;
+    }
+    const Coordinates& max() const
+    {
+        return max_;
+    }
+    size_t rowWords() const
+    {
+        return rowWords_;
+    }
+
+    void set(const Coordinates& coordinates)
+    {
+        const auto row = rowIndex(coordinates[0], coordinates[1]);
+        const auto bit = static_cast<size_t>(coordinates[2] - min_[2]);
+        words_[row * rowWords_ + bit / WORD_BITS] |=
+            uint64_t(1) << (bit % WORD_BITS);
+        nonEmpty_[row] = true;
+    }
+
+    // Nothing for the empty rows and the ones beyond the box
+    const uint64_t* row(int x, int y) const
+    {
+        if (x < min_[0] || x > max_[0] || y < min_[1] || y > max_[1]) {
+            return nullptr;
+        }
+        const auto row = rowIndex(x, y);
+        return nonEmpty_[row] ? &words_[row * rowWords_] : nullptr;
+    }
+
+private:
+    size_t rowIndex(int x, int y) const
+    {
+        return static_cast<size_t>(x - min_[0]) * size_[1] +
+            static_cast<size_t>(y - min_[1]);
+    }
+
+    const Coordinates min_;
+    const Coordinates max_;
+    const Coordinates size_;
+    const size_t rowWords_;
+    std::vector<uint64_t> words_;
+    std::vector<bool> nonEmpty_;
+};
+
+// Boundary voxels of the contour within the box,
+// i.e. the ones overlapping some of its facets
+std::unique_ptr<BoundaryRows> rasterizeBoundary(
+        const std::vector<Facet>& contourFacets,
+        const Mapper& mapper,
+        const Coordinates& min,
+        const Coordinates& max)
+{
+    auto result = std::make_unique<BoundaryRows>(min, max);
+    for (const auto& facet : contourFacets) {
+        const auto localFacet = mapper.toLocal(facet);
+        const auto facetBBox = boundingBox(localFacet);
+        // Same bounds as for overlappingVoxels()
+        if (((intFloor(facetBBox.min()) - Coordinates::constant(1)).array() >
+                    max.array()).any() ||
+                (intFloor(facetBBox.max()).array() < min.array()).any()) {
+            continue;
+        }
+
+        FacetBoxOverlap voxelOverlap(Vector<>::Constant(1.), localFacet);
+        facetPlaneVoxels(localFacet).process(
+                [&] (const Coordinates& coordinates) {
+            if ((coordinates.array() >= min.array()).all() &&
+                    (coordinates.array() <= max.array()).all() &&
+                    voxelOverlap(coordinates.cast<double>().eval())) {
+                result->set(coordinates);
+            }
+        });
+    }
+    return result;
+}
+
+// Sets bit i if any of the bits [i, i + length) is set,
+// the ones beyond the words are considered empty
+void spreadBits(size_t length, std::vector<uint64_t>* words)
+{
+    assert(length > 0);
+    auto& bits = *words;
+    // Bit i already covers [i, i + covered)
+    for (size_t covered = 1; covered < length;) {
+        const size_t shift = std::min(covered, length - covered);
+        const size_t wordShift = shift / WORD_BITS;
+        const size_t bitShift = shift % WORD_BITS;
+        for (size_t k = 0; k < bits.size(); ++k) {
+            const auto at = [&] (size_t index) {
+                return index < bits.size() ? bits[index] : uint64_t(0);
+            };
+            // Words past k are not updated yet
+            uint64_t shifted = at(k + wordShift) >> bitShift;
+            if (bitShift != 0) {
+                shifted |= at(k + wordShift + 1) << (WORD_BITS - bitShift);
+            }
+            bits[k] |= shifted;
+        }
+        covered += shift;
+    }
+}
+
+// Word of the bits [first, first + WORD_BITS) of the row
+uint64_t readWord(const uint64_t* row, size_t rowWords, long first)
+{
+    const auto at = [&] (long index) {
+        return index >= 0 && index < static_cast<long>(rowWords) ?
+            row[index] : uint64_t(0);
+    };
+    // Rounded down for the negative ones as well
+    const long word = first >= 0 ?
+        first / WORD_BITS :
+        -((-first + WORD_BITS - 1) / WORD_BITS);
+    const int bitShift = static_cast<int>(first - word * WORD_BITS);
+    if (bitShift == 0) {
+        return at(word);
+    }
+    return (at(word) >> bitShift) |
+        (at(word + 1) << (WORD_BITS - bitShift));
+}
+
+// Bit i of the result is set if the voxel (x, y, zBegin + i) is a boundary
+// one shifted by some segment offset, for i <= zEnd - zBegin
+void dilateRun(
+        const BoundaryRows& boundary,
+        const std::vector<Segment>& segments,
+        int x, int y, int zBegin, int zEnd,
+        std::vector<uint64_t>* result,
+        std::vector<uint64_t>* window)
+{
+    const size_t runLength = static_cast<size_t>(zEnd - zBegin + 1);
+    result->assign((runLength + WORD_BITS - 1) / WORD_BITS, 0);
+    for (const auto& segment : segments) {
+        const auto* row = boundary.row(x - segment.dx, y - segment.dy);
+        if (!row) {
+            continue;
+        }
+
+        // Bit i of the window is the boundary voxel zBegin + i - zMax,
+        // after spreading it is set if any of [i, i + length) was
+        const size_t length =
+            static_cast<size_t>(segment.zMax - segment.zMin + 1);
+        const long first = static_cast<long>(zBegin) - segment.zMax -
+            boundary.min()[2];
+        window->resize(
+            (runLength + length - 1 + WORD_BITS - 1) / WORD_BITS);
+        for (size_t k = 0; k < window->size(); ++k) {
+            (*window)[k] = readWord(
+                row, boundary.rowWords(),
+                first + static_cast<long>(k * WORD_BITS));
+        }
+        spreadBits(length, window);
+
+        for (size_t k = 0; k < result->size(); ++k) {
+            (*result)[k] |= (*window)[k];
+        }
+    }
+}
+
+bool testBit(const std::vector<uint64_t>& bits, size_t index)
+{
+    return (bits[index / WORD_BITS] >> (index % WORD_BITS)) & 1u;
+}
+
+struct BoundaryCache final {
+    BoundaryCache() = default;
+    // Copies start empty
+    BoundaryCache(const BoundaryCache& /*other*/)
+    {}
+    BoundaryCache& operator=(const BoundaryCache& /*other*/)
+    {
+        minkowskiSum = nullptr;
+        mapper.reset();
+        rows.reset();
+        return *this;
+    }
+
+    const MinkowskiSum* minkowskiSum = nullptr;
+    // Global bounds of the contour
+    Point contourMin;
+    Point contourMax;
+
+    // Grid of the boundary voxels
+    std::optional<Mapper> mapper;
+    std::unique_ptr<BoundaryRows> rows;
+};
+
+} // namespace
+
+MinkowskiSumRasterizer morphologyMSRasterizer(
+        MinkowskiSumRasterizer exactRasterizer,
+        size_t maxBoundaryVoxels)
+{
+    return [
+            exactRasterizer = std::move(exactRasterizer),
+            maxBoundaryVoxels,
+            cache = BoundaryCache{}] (
+            const MinkowskiSum& minkowskiSum,
+            double patternScale,
+            Sampling<Location>* sampling) mutable
+    {
+        assert(DIMS == 3);
+        assert(patternScale > MEPS);
+        std::vector<Voxel<Location>*> voxels;
+        voxels.reserve(sampling->size());
+        sampling->voxels().process([&] (auto& voxel) {
+            voxels.push_back(&voxel);
+        });
+        if (voxels.empty()) {
+            return;
+        }
+
+        // Voxels of a row along the last axis go one after another
+        std::vector<size_t> runEnds;
+        for (size_t i = 1; i <= voxels.size(); ++i) {
+            if (i == voxels.size() ||
+                    voxels[i]->coordinates()[0] !=
+                        voxels[i - 1]->coordinates()[0] ||
+                    voxels[i]->coordinates()[1] !=
+                        voxels[i - 1]->coordinates()[1]) {
+                runEnds.push_back(i);
+            }
+        }
+
+        const double localScale = sampling->toLocal(patternScale);
+        std::vector<std::pair<Point, Point>> bounds;
+        size_t segmentsCount = 0;
+        for (const auto& part : minkowskiSum.patternParts()) {
+            bounds.push_back(offsetBounds(part, localScale));
+            const auto& [min, max] = bounds.back();
+            // Both the touching and the inner ones
+            segmentsCount += 2 * static_cast<size_t>(std::max(0.,
+                (std::floor(max[0]) - std::ceil(min[0]) + 1.) *
+                (std::floor(max[1]) - std::ceil(min[1]) + 1.)));
+        }
+
+        // Segments are processed run by run and the parts voxel by voxel,
+        // so the elements large in voxels are left to the exact rasterizer
+        const auto partsCount = minkowskiSum.convexPartIndices(
+            imageRegion(*sampling), patternScale, patternScale).size();
+        if (runEnds.size() * segmentsCount > voxels.size() * partsCount) {
+            exactRasterizer(minkowskiSum, patternScale, sampling);
+            return;
+        }
+
+        std::vector<Segment> touching;
+        std::vector<Segment> inner;
+        for (size_t i = 0; i < bounds.size(); ++i) {
+            const auto& part = minkowskiSum.patternParts()[i];
+            appendSegments(part, localScale, bounds[i], false, &touching);
+            appendSegments(part, localScale, bounds[i], true, &inner);
+        }
+        if (touching.empty()) {
+            return;
+        }
+
+        if (cache.minkowskiSum != &minkowskiSum) {
+            cache = BoundaryCache{};
+            cache.minkowskiSum = &minkowskiSum;
+            cache.contourMin =
+                Point::constant(std::numeric_limits<double>::infinity());
+            cache.contourMax =
+                Point::constant(-std::numeric_limits<double>::infinity());
+            for (const auto& facet : minkowskiSum.contourFacets()) {
+                for (const auto& vertex : facet) {
+                    cache.contourMin =
+                        cache.contourMin.cwiseMin(vertex).eval();
+                    cache.contourMax =
+                        cache.contourMax.cwiseMax(vertex).eval();
+                }
+            }
+        }
+
+        // Boundary voxels the image of the sampling voxels depends on
+        auto samplingMin = voxels.front()->coordinates();
+        auto samplingMax = samplingMin;
+        for (const auto* voxel : voxels) {
+            samplingMin = samplingMin.cwiseMin(voxel->coordinates()).eval();
+            samplingMax = samplingMax.cwiseMax(voxel->coordinates()).eval();
+        }
+        auto offsetMin =
+            Coordinates::constant(std::numeric_limits<int>::max());
+        auto offsetMax =
+            Coordinates::constant(std::numeric_limits<int>::min());
+        for (const auto& segment : touching) {
+            const Coordinates segmentMin{
+                segment.dx, segment.dy, segment.zMin};
+            const Coordinates segmentMax{
+                segment.dx, segment.dy, segment.zMax};
+            offsetMin = offsetMin.cwiseMin(segmentMin).eval();
+            offsetMax = offsetMax.cwiseMax(segmentMax).eval();
+        }
+        const Coordinates min = (samplingMin - offsetMax).cwiseMax(
+            (intFloor(sampling->toLocal(cache.contourMin)) -
+                Coordinates::constant(1)).eval()).eval();
+        const Coordinates max = (samplingMax - offsetMin).cwiseMin(
+            intFloor(sampling->toLocal(cache.contourMax))).eval();
+        if ((min.array() > max.array()).any()) {
+            // Nothing of the contour is near the sampling
+            return;
+        }
+
+        auto offset = cache.mapper ?
+            alignmentOffset(*sampling, *cache.mapper) :
+            std::nullopt;
+        if (!offset ||
+                ((min + *offset).array() < cache.rows->min().array()).any() ||
+                ((max + *offset).array() > cache.rows->max().array()).any()) {
+            size_t boxVolume = 1;
+            for (size_t i = 0; i < DIMS; ++i) {
+                boxVolume *= static_cast<size_t>(max[i] - min[i] + 1);
+            }
+            if (boxVolume > maxBoundaryVoxels) {
+                exactRasterizer(minkowskiSum, patternScale, sampling);
+                return;
+            }
+
+            cache.mapper.emplace(*sampling);
+            cache.rows = rasterizeBoundary(
+                minkowskiSum.contourFacets(), *sampling, min, max);
+            offset = Coordinates::constant(0);
+        }
+
+        // Voxels touched but not covered by the dilation
+        std::vector<Coordinates> uncertain;
+        std::vector<Location*> uncertainValues;
+        std::vector<uint64_t> touchingBits;
+        std::vector<uint64_t> innerBits;
+        std::vector<uint64_t> window;
+        size_t begin = 0;
+        for (const auto end : runEnds) {
+            const auto& first = voxels[begin]->coordinates();
+            const Coordinates row = (first + *offset).eval();
+            const int zEnd = voxels[end - 1]->coordinates()[2] + (*offset)[2];
+            dilateRun(
+                *cache.rows, touching, row[0], row[1], row[2], zEnd,
+                &touchingBits, &window);
+            dilateRun(
+                *cache.rows, inner, row[0], row[1], row[2], zEnd,
+                &innerBits, &window);
+
+            for (size_t i = begin; i < end; ++i) {
+                const auto bit = static_cast<size_t>(
+                    voxels[i]->coordinates()[2] - first[2]);
+                if (testBit(innerBits, bit)) {
+                    combineLocations(&voxels[i]->value, Location::Inner);
+                } else if (testBit(touchingBits, bit) &&
+                        voxels[i]->value != Location::Inner) {
+                    uncertain.push_back(voxels[i]->coordinates());
+                    uncertainValues.push_back(&voxels[i]->value);
+                }
+            }
+            begin = end;
+        }
+
+        if (uncertain.empty()) {
+            return;
+        }
+        VectorSampling<Location> uncertainSampling(
+            *sampling,
+            VectorSparseRaster<Location>::fromSorted(
+                uncertain, Location::Outer));
+        exactRasterizer(minkowskiSum, patternScale, &uncertainSampling);
+        size_t index = 0;
+        uncertainSampling.voxels().process([&] (const auto& voxel) {
+            combineLocations(uncertainValues[index++], voxel.value);
+        });
+    };
+}
@@ -0,0 +1,27 @@
+// This file is part of xdscribe
+//
+// Copyright (C) 2019 Sergey Karpukhin <contact@kserz.rocks>
+//
+// Licensed under GNU General Public License version 3.
+// Full license text is available in LICENSE file.
+
+#pragma once
+
+#include "solver/inverse/minkowski_sum_rasterizer.h"
+
+#include <cstddef>
+
+// Rasterizes the minkowski sum as a dilation of the contour boundary voxels
+// by the voxelized pattern parts, so the cost depends on the image size
+// rather than on the contour facets count.
+// A voxel is inner if a pattern part shifted to some boundary voxel covers
+// the neighbourhood of a voxel around it and outer if no part meets such
+// a neighbourhood. The rest are only known to be near the image boundary
+// and are left to the exact rasterizer, so is the whole sampling when
+// the pattern is too large in voxels for the dilation to pay off.
+// The boundary voxels are kept for the grid and only rebuilt once
+// the sampling leaves their box. Boxes of more than maxBoundaryVoxels
+// voxels are left to the exact rasterizer as well.
+MinkowskiSumRasterizer morphologyMSRasterizer(
+        MinkowskiSumRasterizer exactRasterizer,
+        size_t maxBoundaryVoxels = size_t(1) << 28);
@@ -0,0 +1,243 @@
+// This file is part of xdscribe
+//
+// Copyright (C) 2019 Sergey Karpukhin <contact@kserz.rocks>
+//
+// Licensed under GNU General Public License version 3.
+// Full license text is available in LICENSE file.
+
+#include "scale_interval_rasterizer.h"
+
+#include "geometry/entity/bounding_box.h"
+#include "grid/rasterization/facet_box_overlap.h"
+#include "grid/sampling/vector_sampling.h"
+#include "grid/sampling/vector_sparse_raster.h"
+
+#include <algorithm>
+#include <limits>
+#include <memory>
+#include <utility>
+#include <vector>
+
+namespace {
+
+// Scales interval satisfying a set of linear constraints
+struct ScaleInterval final {
+    bool empty() const
+    {
+        return min > max;
+    }
+
+    // distance - scale * slope <= 0
+    void constrain(double distance, double slope)
+    {
+        if (slope > 0.) {
+            min = std::max(min, distance / slope);
+        } else if (slope < 0.) {
+            max = std::min(max, distance / slope);
+        } else if (distance > 0.) {
+            min = std::numeric_limits<double>::infinity();
+            max = -std::numeric_limits<double>::infinity();
+        }
+    }
+
+    double min = -std::numeric_limits<double>::infinity();
+    double max = std::numeric_limits<double>::infinity();
+};
+
+// Halfspaces of a part in local coordinates with offsets affine in the scale
+struct LocalPart final {
+    std::vector<Vector<>> normals;
+    std::vector<Vector<>> lowestPoints;
+    std::vector<double> offsets0;
+    std::vector<double> offsetSlopes;
+    std::vector<double> sizeProjections;
+};
+
+LocalPart localPart(
+        const MinkowskiSum::HalfspaceTable& halfspaces,
+        const Mapper& mapper)
+{
+    LocalPart result;
+    for (size_t j = 0; j < halfspaces.size(); ++j) {
+        Vector<> normal;
+        for (size_t i = 0; i < DIMS; ++i) {
+            normal[i] = halfspaces.normals[i][j];
+        }
+
+        result.normals.push_back(normal);
+        // Voxels are unit cubes in local coordinates
+        result.lowestPoints.push_back(FacetBoxOverlap::lowestPoint(
+            Vector<>::Constant(1.), normal));
+        // Mapping to local coordinates keeps the unit normal as it is
+        result.offsets0.push_back(normal.dot(mapper.toLocal(
+            Point((halfspaces.offsets0[j] * normal).eval()))));
+        result.offsetSlopes.push_back(
+            mapper.toLocal(halfspaces.offsetSlopes[j]));
+        result.sizeProjections.push_back(normal.cwiseAbs().sum());
+    }
+    return result;
+}
+
+struct ScaleIntervalCache final {
+    ScaleIntervalCache() = default;
+    // Copies start empty
+    ScaleIntervalCache(const ScaleIntervalCache& /*other*/)
+    {}
+    ScaleIntervalCache& operator=(const ScaleIntervalCache& /*other*/)
+    {
+        image.reset();
+        return *this;
+    }
+
+    const MinkowskiSum* minkowskiSum = nullptr;
+    double minScale = 0.;
+    double maxScale = 0.;
+    std::unique_ptr<VectorSampling<CriticalScales>> image;
+};
+
+// Returns false if the cached image does not cover the request
+bool applyCache(
+        const ScaleIntervalCache& cache,
+        const MinkowskiSum& minkowskiSum,
+        double patternScale,
+        Sampling<Location>* sampling)
+{
+    if (!cache.image ||
+            cache.minkowskiSum != &minkowskiSum ||
+            patternScale < cache.minScale ||
+            patternScale > cache.maxScale) {
+        return false;
+    }
+
+    const auto offset = alignmentOffset(*sampling, *cache.image);
+    if (!offset) {
+        return false;
+    }
+
+    std::vector<std::pair<Location*, const CriticalScales*>> matches;
+    matches.reserve(sampling->size());
+    bool covered = true;
+    joinVoxels(
+        sampling->voxels(),
+        std::as_const(*cache.image).voxels(),
+        *offset,
+        [&] (Voxel<Location>& voxel, const Voxel<CriticalScales>* cached) {
+            if (!cached) {
+                covered = false;
+            } else if (covered) {
+                matches.emplace_back(&voxel.value, &cached->value);
+            }
+        });
+    if (!covered) {
+        return false;
+    }
+
+    for (const auto& [value, scales] : matches) {
+        combineLocations(value, scales->location(patternScale));
+    }
+    return true;
+}
+
+} // namespace
+
+void rasterizeCriticalScales(
+        const MinkowskiSum& minkowskiSum,
+        double minScale,
+        double maxScale,
+        Sampling<CriticalScales>* sampling)
+{
+    assert(minScale > MEPS);
+    assert(maxScale >= minScale);
+
+    const auto partIndices = minkowskiSum.convexPartIndices(
+        imageRegion(*sampling), minScale, maxScale);
+    for (const auto partIndex : partIndices) {
+        // Vertices are affine in the scale, so their extrema over
+        // the scale interval are reached at its endpoints
+        const auto minPart = minkowskiSum.convexPart(partIndex, minScale);
+        const auto maxPart = minkowskiSum.convexPart(partIndex, maxScale);
+        const BoundingBox windowBBox{
+            minPart.boundingBox.min().cwiseMin(
+                maxPart.boundingBox.min()).eval(),
+            minPart.boundingBox.max().cwiseMax(
+                maxPart.boundingBox.max()).eval()
+        };
+
+        const auto part = localPart(minPart.halfspaces, *sampling);
+        overlappingVoxels(sampling, sampling->toLocal(windowBBox)).process(
+                [&] (Voxel<CriticalScales>& voxel) {
+            const Vector<> corner = voxel.coordinates().cast<double>();
+            // Scales the voxel is not outer and inner for the part at
+            ScaleInterval touching;
+            ScaleInterval inner;
+            bool innerPossible = true;
+
+            for (size_t j = 0; j < part.normals.size(); ++j) {
+                const double distance =
+                    part.normals[j].dot(corner + part.lowestPoints[j]) -
+                    part.offsets0[j];
+                const double slope = part.offsetSlopes[j];
+
+                touching.constrain(distance - MEPS, slope);
+                if (touching.empty() ||
+                        touching.min > maxScale ||
+                        touching.max < minScale) {
+                    return;
+                }
+
+                if (innerPossible) {
+                    inner.constrain(
+                        distance + part.sizeProjections[j] + MEPS, slope);
+                    innerPossible = !inner.empty() &&
+                        inner.min <= maxScale &&
+                        inner.max >= maxScale;
+                }
+            }
+
+            auto& scales = voxel.value;
+            scales.boundary = std::min(scales.boundary, touching.min);
+            if (innerPossible) {
+                scales.inner = std::min(scales.inner, inner.min);
+            }
+        });
+    }
+}
+
+MinkowskiSumRasterizer scaleIntervalMSRasterizer(double windowGridSteps)
+{
+    assert(windowGridSteps >= 0.);
+    return [cache = ScaleIntervalCache{}, windowGridSteps] (
+            const MinkowskiSum& minkowskiSum,
+            double patternScale,
+            Sampling<Location>* sampling) mutable {
+        if (applyCache(cache, minkowskiSum, patternScale, sampling)) {
+            return;
+        }
+
+        cache.minkowskiSum = &minkowskiSum;
+        cache.minScale = patternScale;
+        cache.maxScale = patternScale +
+            windowGridSteps * sampling->gridStep();
+        cache.image = std::make_unique<VectorSampling<CriticalScales>>(
+            *sampling,
+            VectorSparseRaster<CriticalScales>{
+                mapGenerator<const Coordinates&>(
+                    sampling->voxels(),
+                    [] (const auto& voxel) {
+                        return voxel.coordinates();
+                    }),
+                CriticalScales{},
+                sampling->size()
+            });
+        rasterizeCriticalScales(
+            minkowskiSum,
+            cache.minScale,
+            cache.maxScale,
+            cache.image.get());
+
+        const bool applied =
+            applyCache(cache, minkowskiSum, patternScale, sampling);
+        assert(applied);
+        (void)applied;
+    };
+}
@@ -0,0 +1,51 @@
+// This file is part of xdscribe
+//
+// Copyright (C) 2019 Sergey Karpukhin <contact@kserz.rocks>
+//
+// Licensed under GNU General Public License version 3.
+// Full license text is available in LICENSE file.
+
+#pragma once
+
+#include "geometry/location/location.h"
+#include "grid/sampling/sampling.h"
+#include "solver/inverse/minkowski_sum.h"
+#include "solver/inverse/minkowski_sum_rasterizer.h"
+
+#include <limits>
+
+// Pattern scales since which a voxel is covered by the minkowski sum image
+struct CriticalScales final {
+    Location location(double scale) const
+    {
+        if (scale >= inner) {
+            return Location::Inner;
+        }
+        return scale >= boundary ? Location::Boundary : Location::Outer;
+    }
+
+    double boundary = std::numeric_limits<double>::infinity();
+    double inner = std::numeric_limits<double>::infinity();
+};
+
+// Rasterizes the minkowski sum by halfspaces for all the scales at once,
+// the result is valid for the scales within [minScale, maxScale].
+// It is exact for the convex parts growing with the scale, i.e. those
+// containing the pattern origin. Otherwise a voxel is only considered
+// inner since it stays inside a single part up to maxScale and gaps
+// between the parts touching it are ignored, both are safe
+// for the domain estimation.
+void rasterizeCriticalScales(
+        const MinkowskiSum& minkowskiSum,
+        double minScale,
+        double maxScale,
+        Sampling<CriticalScales>* sampling);
+
+// Keeps critical scales of the voxels for a window of scales
+// starting with the requested one and answers the images within it
+// by a comparison. The window is rebuilt once the grid changes
+// or the selection is no more covered by it.
+// Copies of the rasterizer start with an empty cache, so every
+// domain estimator holding one reuses only its own images.
+MinkowskiSumRasterizer scaleIntervalMSRasterizer(
+        double windowGridSteps = 8.);
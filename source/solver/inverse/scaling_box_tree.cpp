@@ -0,0 +1,136 @@
+// This file is part of xdscribe
+//
+// Copyright (C) 2019 Sergey Karpukhin <contact@kserz.rocks>
+//
+// Licensed under GNU General Public License version 3.
+// Full license text is available in LICENSE file.
+
+#include "scaling_box_tree.h"
+
+#include <algorithm>
+#include <numeric>
+
+namespace {
+
+ScalingBox boxUnion(const ScalingBox& lhs, const ScalingBox& rhs)
+{
+    return {
+        lhs.originMin.cwiseMin(rhs.originMin).eval(),
+        lhs.originMax.cwiseMax(rhs.originMax).eval(),
+        lhs.directionMin.cwiseMin(rhs.directionMin).eval(),
+        lhs.directionMax.cwiseMax(rhs.directionMax).eval()
+    };
+}
+
+// The box center at the unit scale
+Point splitPoint(const ScalingBox& box)
+{
+    return ((box.originMin + box.directionMin +
+        box.originMax + box.directionMax) / 2.).eval();
+}
+
+} // namespace
+
+bool ScalingBox::intersects(
+        const BoundingBox& region,
+        double minScale,
+        double maxScale) const
+{
+    assert(minScale >= 0.);
+    assert(maxScale >= minScale);
+    for (size_t i = 0; i < DIMS; ++i) {
+        // Bounds are affine, so the extremal ones are at the range ends
+        const double lowest = originMin[i] + std::min(
+            minScale * directionMin[i], maxScale * directionMin[i]);
+        const double highest = originMax[i] + std::max(
+            minScale * directionMax[i], maxScale * directionMax[i]);
+        if (lowest > region.max()[i] + MEPS ||
+                highest < region.min()[i] - MEPS) {
+            return false;
+        }
+    }
+    return true;
+}
+
+ScalingBoxTree::ScalingBoxTree(std::vector<ScalingBox> boxes)
+    : boxes_(std::move(boxes))
+    , order_(boxes_.size())
+{
+    std::iota(order_.begin(), order_.end(), 0);
+    if (!boxes_.empty()) {
+        nodes_.reserve(2 * boxes_.size() / LEAF_SIZE + 1);
+        build(0, boxes_.size());
+    }
+}
+
+size_t ScalingBoxTree::build(size_t begin, size_t end)
+{
+    assert(begin < end);
+    const size_t nodeIndex = nodes_.size();
+    auto box = boxes_[order_[begin]];
+    for (size_t i = begin + 1; i < end; ++i) {
+        box = boxUnion(box, boxes_[order_[i]]);
+    }
+    nodes_.push_back(Node{std::move(box), begin, end, 0});
+
+    if (end - begin <= LEAF_SIZE) {
+        return nodeIndex;
+    }
+
+    // Median split along the widest axis at the unit scale
+    const auto& nodeBox = nodes_[nodeIndex].box;
+    Vector<> extent = (nodeBox.originMax + nodeBox.directionMax -
+        nodeBox.originMin - nodeBox.directionMin).eval();
+    size_t axis = 0;
+    extent.maxCoeff(&axis);
+
+    const size_t middle = begin + (end - begin) / 2;
+    std::nth_element(
+        order_.begin() + begin,
+        order_.begin() + middle,
+        order_.begin() + end,
+        [&] (size_t lhs, size_t rhs) {
+            return splitPoint(boxes_[lhs])[axis] <
+                splitPoint(boxes_[rhs])[axis];
+        });
+
+    build(begin, middle);
+    const size_t secondChild = build(middle, end);
+    nodes_[nodeIndex].secondChild = secondChild;
+    return nodeIndex;
+}
+
+std::vector<size_t> ScalingBoxTree::intersecting(
+        const BoundingBox& region,
+        double minScale,
+        double maxScale) const
+{
+    std::vector<size_t> result;
+    if (nodes_.empty()) {
+        return result;
+    }
+
+    std::vector<size_t> stack{0};
+    while (!stack.empty()) {
+        const auto& node = nodes_[stack.back()];
+        const size_t nodeIndex = stack.back();
+        stack.pop_back();
+        if (!node.box.intersects(region, minScale, maxScale)) {
+            continue;
+        }
+
+        if (node.secondChild == 0) {
+            for (size_t i = node.begin; i < node.end; ++i) {
+                if (boxes_[order_[i]].intersects(region, minScale, maxScale)) {
+                    result.push_back(order_[i]);
+                }
+            }
+        } else {
+            stack.push_back(node.secondChild);
+            stack.push_back(nodeIndex + 1);
+        }
+    }
+
+    std::sort(result.begin(), result.end());
+    return result;
+}
@@ -0,0 +1,63 @@
+// This file is part of xdscribe
+//
+// Copyright (C) 2019 Sergey Karpukhin <contact@kserz.rocks>
+//
+// Licensed under GNU General Public License version 3.
+// Full license text is available in LICENSE file.
+
+#pragma once
+
+#include "geometry/entity/bounding_box.h"
+#include "geometry/kernel.h"
+
+#include <vector>
+
+// Axis-aligned box with the bounds affine in the scale:
+//     originMin + scale * directionMin <= point
+//     point <= originMax + scale * directionMax
+// Bounds a convex hull of the points origin + scale * direction
+// for all the non-negative scales.
+struct ScalingBox final {
+    // Box at the scale within [minScale, maxScale] intersects the region
+    bool intersects(
+            const BoundingBox& region,
+            double minScale,
+            double maxScale) const;
+
+    Point originMin;
+    Point originMax;
+    Vector<> directionMin;
+    Vector<> directionMax;
+};
+
+// Bounding volume hierarchy over the scaling boxes
+class ScalingBoxTree final {
+public:
+    explicit ScalingBoxTree(std::vector<ScalingBox> boxes);
+
+    // Indices of the boxes intersecting the region at some scale
+    // within [minScale, maxScale] in increasing order
+    std::vector<size_t> intersecting(
+            const BoundingBox& region,
+            double minScale,
+            double maxScale) const;
+
+private:
+    static constexpr size_t LEAF_SIZE = 4;
+
+    struct Node {
+        ScalingBox box;
+        // Range of the boxes in the order
+        size_t begin;
+        size_t end;
+        // Children are the next node and the one at the index,
+        // zero for a leaf
+        size_t secondChild;
+    };
+
+    size_t build(size_t begin, size_t end);
+
+    const std::vector<ScalingBox> boxes_;
+    std::vector<size_t> order_;
+    std::vector<Node> nodes_;
+};
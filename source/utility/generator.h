@@ -53,6 +53,12 @@ public:
         }
     }
 
+    // Vector the values are taken from, nullptr for the generated ones
+    VectorStoragePointer storage() const
+    {
+        return storage_;
+    }
+
 private:
     const Source source_;
     VectorStoragePointer const storage_;
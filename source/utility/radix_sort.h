@@ -0,0 +1,47 @@
+// This file is part of xdscribe
+//
+// Copyright (C) 2019 Sergey Karpukhin <contact@kserz.rocks>
+//
+// Licensed under GNU General Public License version 3.
+// Full license text is available in LICENSE file.
+
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// Sorts the keys digit by digit starting with the lowest one.
+// Digits equal for all the keys are skipped, so the keys
+// sharing the high bits take just a few passes.
+inline void radixSort(std::vector<uint64_t>* keys)
+{
+    constexpr unsigned DIGIT_BITS = 11;
+    constexpr size_t BUCKETS_COUNT = size_t{1} << DIGIT_BITS;
+    constexpr uint64_t DIGIT_MASK = BUCKETS_COUNT - 1;
+
+    std::vector<uint64_t> buffer(keys->size());
+    std::array<size_t, BUCKETS_COUNT> offsets;
+    for (unsigned shift = 0; shift < 64; shift += DIGIT_BITS) {
+        offsets.fill(0);
+        for (const auto key : *keys) {
+            ++offsets[(key >> shift) & DIGIT_MASK];
+        }
+        if (!keys->empty() && offsets[((*keys)[0] >> shift) & DIGIT_MASK] ==
+                keys->size()) {
+            continue;
+        }
+
+        size_t offset = 0;
+        for (auto& bucketOffset : offsets) {
+            const auto bucketSize = bucketOffset;
+            bucketOffset = offset;
+            offset += bucketSize;
+        }
+        for (const auto key : *keys) {
+            buffer[offsets[(key >> shift) & DIGIT_MASK]++] = key;
+        }
+        keys->swap(buffer);
+    }
+}
@@ -0,0 +1,225 @@
+// This file is part of xdscribe
+//
+// Copyright (C) 2019 Sergey Karpukhin <contact@kserz.rocks>
+//
+// Licensed under GNU General Public License version 3.
+// Full license text is available in LICENSE file.
+
+#include "work_stealing_pool.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cassert>
+#include <exception>
+#include <system_error>
+
+namespace {
+
+// Tasks left for a single worker
+struct TaskRange final {
+    std::mutex mutex;
+    size_t begin = 0;
+    size_t end = 0;
+};
+
+} // namespace
+
+// Tasks of a single run shared by the workers taking part in it
+struct WorkStealingPool::Batch final {
+    Batch(size_t tasksCount, size_t workersCount, const Task& task)
+        : task(task)
+        , workersCount(workersCount)
+        , ranges(workersCount)
+    {
+        for (size_t worker = 0; worker < workersCount; ++worker) {
+            ranges[worker].begin = tasksCount * worker / workersCount;
+            ranges[worker].end = tasksCount * (worker + 1) / workersCount;
+        }
+    }
+
+    bool takeOwn(size_t worker, size_t* taskIndex)
+    {
+        auto& range = ranges[worker];
+        std::lock_guard<std::mutex> lock(range.mutex);
+        if (range.begin == range.end) {
+            return false;
+        }
+        *taskIndex = range.begin++;
+        return true;
+    }
+
+    // Moves the back half of the largest range to the empty worker's one
+    bool steal(size_t worker)
+    {
+        while (true) {
+            size_t victim = worker;
+            size_t largestSize = 0;
+            for (size_t other = 0; other < workersCount; ++other) {
+                if (other == worker) {
+                    continue;
+                }
+                std::lock_guard<std::mutex> lock(ranges[other].mutex);
+                const auto size = ranges[other].end - ranges[other].begin;
+                if (size > largestSize) {
+                    victim = other;
+                    largestSize = size;
+                }
+            }
+            if (largestSize == 0) {
+                return false;
+            }
+
+            size_t begin = 0;
+            size_t end = 0;
+            {
+                auto& victimRange = ranges[victim];
+                std::lock_guard<std::mutex> lock(victimRange.mutex);
+                const auto size = victimRange.end - victimRange.begin;
+                if (size == 0) {
+                    // Someone was faster, look for another victim
+                    continue;
+                }
+                end = victimRange.end;
+                victimRange.end -= (size + 1) / 2;
+                begin = victimRange.end;
+            }
+
+            auto& range = ranges[worker];
+            std::lock_guard<std::mutex> lock(range.mutex);
+            assert(range.begin == range.end);
+            range.begin = begin;
+            range.end = end;
+            return true;
+        }
+    }
+
+    void work(size_t worker)
+    {
+        size_t taskIndex = 0;
+        while (!failed) {
+            if (!takeOwn(worker, &taskIndex)) {
+                if (steal(worker)) {
+                    continue;
+                }
+                break;
+            }
+
+            try {
+                task(worker, taskIndex);
+            } catch (...) {
+                std::lock_guard<std::mutex> lock(failureMutex);
+                if (!failure) {
+                    failure = std::current_exception();
+                }
+                failed = true;
+            }
+        }
+    }
+
+    const Task& task;
+    const size_t workersCount;
+    std::vector<TaskRange> ranges;
+
+    std::atomic<bool> failed{false};
+    std::exception_ptr failure;
+    std::mutex failureMutex;
+};
+
+size_t WorkStealingPool::defaultWorkersCount()
+{
+    return std::max<size_t>(std::thread::hardware_concurrency(), 1);
+}
+
+WorkStealingPool::WorkStealingPool(size_t workersCount)
+    : workersCount_(std::max<size_t>(workersCount, 1))
+{}
+
+WorkStealingPool::~WorkStealingPool()
+{
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stopping_ = true;
+    }
+    batchStarted_.notify_all();
+    for (auto& thread : threads_) {
+        thread.join();
+    }
+}
+
+void WorkStealingPool::run(size_t tasksCount, const Task& task)
+{
+    std::lock_guard<std::mutex> runLock(runMutex_);
+    if (std::min(workersCount_, tasksCount) > 1) {
+        startThreads();
+    }
+
+    // Ranges of the workers not started are never assigned
+    const size_t workersCount = std::min(threads_.size() + 1, tasksCount);
+    if (workersCount <= 1) {
+        for (size_t taskIndex = 0; taskIndex < tasksCount; ++taskIndex) {
+            task(0, taskIndex);
+        }
+        return;
+    }
+
+    Batch batch(tasksCount, workersCount, task);
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        batch_ = &batch;
+        ++batchNumber_;
+        busyThreads_ = workersCount - 1;
+    }
+    batchStarted_.notify_all();
+
+    batch.work(0);
+    {
+        std::unique_lock<std::mutex> lock(mutex_);
+        batchDone_.wait(lock, [this] { return busyThreads_ == 0; });
+        batch_ = nullptr;
+    }
+
+    if (batch.failure) {
+        std::rethrow_exception(batch.failure);
+    }
+}
+
+void WorkStealingPool::startThreads()
+{
+    while (threads_.size() + 1 < workersCount_) {
+        try {
+            threads_.emplace_back(
+                &WorkStealingPool::serve, this, threads_.size() + 1);
+        } catch (const std::system_error&) {
+            // The started ones take the tasks of the rest
+            break;
+        }
+    }
+}
+
+void WorkStealingPool::serve(size_t workerIndex)
+{
+    size_t servedBatch = 0;
+    std::unique_lock<std::mutex> lock(mutex_);
+    while (true) {
+        batchStarted_.wait(lock, [&] {
+            return stopping_ || batchNumber_ != servedBatch;
+        });
+        if (stopping_) {
+            return;
+        }
+        servedBatch = batchNumber_;
+        // Batches of few tasks are done without some threads,
+        // those may only wake up once they are over
+        if (!batch_ || workerIndex >= batch_->workersCount) {
+            continue;
+        }
+
+        auto* batch = batch_;
+        lock.unlock();
+        batch->work(workerIndex);
+        lock.lock();
+        if (--busyThreads_ == 0) {
+            batchDone_.notify_one();
+        }
+    }
+}
@@ -0,0 +1,65 @@
+// This file is part of xdscribe
+//
+// Copyright (C) 2019 Sergey Karpukhin <contact@kserz.rocks>
+//
+// Licensed under GNU General Public License version 3.
+// Full license text is available in LICENSE file.
+
+#pragma once
+
+#include "utility/noncopyable.h"
+
+#include <condition_variable>
+#include <cstddef>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// Runs batches of independent indexed tasks on several threads.
+// Every worker starts with an equal contiguous range of task indices
+// and takes tasks from its front, an idle worker steals the back half
+// of the largest range left. The calling thread serves as worker 0,
+// the other workers are threads started by the first batch needing
+// them and kept waiting for the next batches until the pool is gone.
+class WorkStealingPool final : public NonCopyable {
+public:
+    using Task = std::function<void(size_t workerIndex, size_t taskIndex)>;
+
+    static size_t defaultWorkersCount();
+
+    explicit WorkStealingPool(size_t workersCount = defaultWorkersCount());
+    ~WorkStealingPool();
+
+    size_t workersCount() const
+    {
+        return workersCount_;
+    }
+
+    // Blocks until all the tasks are done.
+    // The first exception thrown by a task is rethrown here
+    // after the remaining tasks are dropped.
+    // Batches run one at a time, tasks are not to run batches
+    // of the same pool.
+    void run(size_t tasksCount, const Task& task);
+
+private:
+    struct Batch;
+
+    // Starts the threads not running yet, as many as the system allows
+    void startThreads();
+    void serve(size_t workerIndex);
+
+    const size_t workersCount_;
+
+    std::mutex runMutex_;
+
+    std::mutex mutex_;
+    std::condition_variable batchStarted_;
+    std::condition_variable batchDone_;
+    Batch* batch_ = nullptr;
+    size_t batchNumber_ = 0;
+    size_t busyThreads_ = 0;
+    bool stopping_ = false;
+    std::vector<std::thread> threads_;
+};
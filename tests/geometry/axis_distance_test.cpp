@@ -49,3 +49,30 @@ TEST_CASE("axis distance")
     REQUIRE(!dist4);
 
 }
+
+TEST_CASE("axis distance under uniform mapping")
+{
+    const Facet facet{
+        Point{5, 7, 6},
+        Point{2, 4, 3},
+        Point{9, 6, 5}};
+    const Point point{4, 5, 2};
+    const auto expected = AxisDistance(facet)(point);
+
+    const double scale = 37.5;
+    const Point shift{-3., 11., 0.25};
+    const auto map = [&] (const Point& p) {
+        return Point((scale * p + shift).eval());
+    };
+    const auto mapped = AxisDistance(Facet{
+        map(facet[0]), map(facet[1]), map(facet[2])})(map(point));
+    REQUIRE(mapped.location() == expected.location());
+    REQUIRE(mapped.value() == Approx(scale * expected.value()).epsilon(1e-9));
+
+    // Vertical facets are skipped at any scale
+    REQUIRE(!AxisDistance(Facet{
+        Point{0, 0, 0},
+        Point{1e-3, 1e-3, 0},
+        Point{0, 0, 1e-3}})
+            (Point{5e-4, 5e-4, -1.}));
+}
@@ -0,0 +1,67 @@
+#include "geometry/location/location.h"
+#include "geometry/location/packed_locations.h"
+
+#include <catch2/catch.hpp>
+
+#include <algorithm>
+#include <random>
+#include <vector>
+
+TEST_CASE("packed locations")
+{
+    std::mt19937 random(7);
+    std::uniform_int_distribution<int> location(0, 2);
+
+    // Sizes cover full and partially filled last words
+    for (const size_t size : {0, 1, 31, 32, 33, 100}) {
+        std::vector<Location> lhs;
+        std::vector<Location> rhs;
+        PackedLocations packedLhs;
+        PackedLocations packedRhs;
+        for (size_t i = 0; i < size; ++i) {
+            lhs.push_back(static_cast<Location>(location(random)));
+            rhs.push_back(static_cast<Location>(location(random)));
+            packedLhs.push_back(lhs.back());
+            packedRhs.push_back(rhs.back());
+        }
+
+        REQUIRE(packedLhs.size() == size);
+        for (size_t i = 0; i < size; ++i) {
+            REQUIRE(packedLhs[i] == lhs[i]);
+        }
+        for (const auto value :
+                {Location::Outer, Location::Boundary, Location::Inner}) {
+            REQUIRE(packedLhs.count(value) == static_cast<size_t>(
+                std::count(lhs.begin(), lhs.end(), value)));
+        }
+
+        // Lane-wise maximum of the locations
+        PackedLocations united;
+        PackedLocations::transform(
+            packedLhs,
+            packedRhs,
+            [] (uint64_t lhsWord, uint64_t rhsWord) {
+                const auto low = PackedLocations::LOW_BITS;
+                const uint64_t inner = ((lhsWord | rhsWord) >> 1) & low;
+                const uint64_t boundary = (lhsWord | rhsWord) & low & ~inner;
+                return (inner << 1) | boundary;
+            },
+            &united);
+        REQUIRE(united.size() == size);
+        for (size_t i = 0; i < size; ++i) {
+            REQUIRE(united[i] == std::max(lhs[i], rhs[i]));
+        }
+
+        // Lanes past the size are not counted
+        PackedLocations filled;
+        PackedLocations::transform(
+            packedLhs,
+            packedRhs,
+            [] (uint64_t /*lhsWord*/, uint64_t /*rhsWord*/) {
+                return PackedLocations::LOW_BITS << 1;
+            },
+            &filled);
+        REQUIRE(filled.count(Location::Inner) == size);
+        REQUIRE(filled.count(Location::Outer) == 0);
+    }
+}
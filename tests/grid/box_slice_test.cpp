@@ -0,0 +1,118 @@
+#include "grid/sampling/box_raster_view.h"
+#include "grid/sampling/vector_sparse_raster.h"
+
+#include <catch2/catch.hpp>
+
+#include <algorithm>
+#include <vector>
+
+namespace {
+
+bool inside(
+        const Coordinates& coordinates,
+        const Coordinates& min,
+        const Coordinates& max)
+{
+    for (size_t i = 0; i < DIMS; ++i) {
+        if (coordinates[i] < min[i] || coordinates[i] > max[i]) {
+            return false;
+        }
+    }
+    return true;
+}
+
+std::vector<Coordinates> collect(const Generator<Voxel<int>&>& voxels)
+{
+    std::vector<Coordinates> result;
+    voxels.process([&] (const Voxel<int>& voxel) {
+        result.push_back(voxel.coordinates());
+    });
+    return result;
+}
+
+std::vector<Coordinates> filter(
+        SparseRaster<int>* raster,
+        const Coordinates& min,
+        const Coordinates& max)
+{
+    std::vector<Coordinates> result;
+    raster->voxels().process([&] (const Voxel<int>& voxel) {
+        if (inside(voxel.coordinates(), min, max)) {
+            result.push_back(voxel.coordinates());
+        }
+    });
+    return result;
+}
+
+} // namespace
+
+TEST_CASE("box slice")
+{
+    // Checkerboard-like sparse selection
+    const Coordinates rasterSize{7, 6, 5};
+    std::vector<Coordinates> selection;
+    XDIterator<DIMS>::run(rasterSize, [&] (const Coordinates& coordinates) {
+        if ((coordinates[0] + 2 * coordinates[1] + coordinates[2]) % 3 != 0) {
+            selection.push_back(coordinates);
+        }
+    });
+    VectorSparseRaster<int> raster(selection, 0);
+
+    const std::vector<std::pair<Coordinates, Coordinates>> boxes{
+        {{0, 0, 0}, {6, 5, 4}},
+        {{2, 1, 3}, {4, 4, 3}},
+        {{-3, -3, -3}, {1, 2, 10}},
+        {{5, 5, 4}, {9, 9, 9}},
+        {{3, 3, 3}, {3, 3, 3}},
+        {{4, 2, 2}, {3, 5, 5}},
+        {{8, 0, 0}, {9, 5, 4}}
+    };
+
+    for (const auto& box : boxes) {
+        const auto expected = filter(&raster, box.first, box.second);
+        REQUIRE(collect(raster.boxSlice(box.first, box.second)) == expected);
+
+        BoxRasterView<int> view(&raster, box.first, box.second);
+        REQUIRE(view.size() == expected.size());
+        REQUIRE(collect(view.voxels()) == expected);
+
+        for (const auto& coordinates : selection) {
+            const auto* voxel = view.find(coordinates);
+            REQUIRE((voxel != nullptr) ==
+                inside(coordinates, box.first, box.second));
+        }
+
+        const Coordinates innerMin{3, 0, 1};
+        const Coordinates innerMax{6, 2, 4};
+        REQUIRE(collect(view.boxSlice(innerMin, innerMax)) == filter(
+            &raster,
+            box.first.cwiseMax(innerMin).eval(),
+            box.second.cwiseMin(innerMax).eval()));
+
+        const Coordinates columnStart{3, 2, 0};
+        auto columnMax = columnStart;
+        columnMax[DIMS-1] = rasterSize[DIMS-1];
+        REQUIRE(collect(view.verticalSlice(columnStart)) == filter(
+            &raster,
+            box.first.cwiseMax(columnStart).eval(),
+            box.second.cwiseMin(columnMax).eval()));
+    }
+}
+
+TEST_CASE("overlapping voxels")
+{
+    VectorSparseRaster<int> raster(Coordinates{4, 4, 4}, 0);
+
+    const BoundingBox box{{1.5, 1., 0.2}, {2.5, 1.7, 0.8}};
+    const auto voxels = collect(overlappingVoxels(&raster, box));
+
+    // Every voxel intersecting the box is present
+    for (const auto& coordinates : std::vector<Coordinates>{
+            {1, 1, 0}, {2, 1, 0}}) {
+        REQUIRE(std::find(voxels.begin(), voxels.end(), coordinates)
+            != voxels.end());
+    }
+    for (const auto& coordinates : voxels) {
+        REQUIRE(inside(coordinates, {0, 0, 0}, {2, 1, 0}));
+    }
+}
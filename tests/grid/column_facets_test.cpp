@@ -0,0 +1,64 @@
+#include "geometry/entity/bounding_box.h"
+#include "geometry/entity/polytope.h"
+#include "geometry/location/axis_distance.h"
+#include "grid/rasterization/column_facets.h"
+#include "grid/sampling/vector_sampling.h"
+#include "grid/sampling/xd_iterator.h"
+
+#include <catch2/catch.hpp>
+
+#include <algorithm>
+#include <vector>
+
+TEST_CASE("column facets")
+{
+    const auto polytope = Polytope::loadObj("examples/heart_320.obj");
+    const Box container = boundingBox(polytope.vertices());
+    const VectorSampling<Location> sampling{
+        {container.center(), container.radius() * 1.1},
+        16,
+        Location::Outer};
+    const auto localGeometry = sampling.toLocal(polytope.facetGeometries());
+
+    // Columns of a part of the grid only
+    const Coordinates min{2, 3, 0};
+    const Coordinates max{13, 11, 0};
+    const ColumnFacets columns{localGeometry, min, max};
+
+    std::vector<Facet> facets;
+    localGeometry.process([&] (const Facet& facet) {
+        facets.push_back(facet);
+    });
+    REQUIRE(columns.facets().size() <= facets.size());
+
+    size_t columnsCount = 0;
+    size_t totalCount = 0;
+    XDIterator<DIMS-1>::run(
+            (max - min + Coordinates::constant(1)).eval(),
+            [&] (const Coordinates& offset) {
+        const Coordinates column = (min + offset).eval();
+        REQUIRE(std::is_sorted(columns.begin(column), columns.end(column)));
+        ++columnsCount;
+        totalCount += columns.end(column) - columns.begin(column);
+
+        // Every facet hit by a ray through the column is there
+        std::vector<Facet> columnFacets;
+        columns.columnGeometry(column).process([&] (const Facet& facet) {
+            columnFacets.push_back(facet);
+        });
+        for (const auto& facet : facets) {
+            const AxisDistance distance{facet};
+            for (const double shift : {0., 0.5, 1.}) {
+                const Point testPoint{
+                    column[0] + shift, column[1] + 1. - shift, -1.};
+                if (distance(testPoint)) {
+                    REQUIRE(std::find(
+                        columnFacets.begin(), columnFacets.end(), facet) !=
+                        columnFacets.end());
+                }
+            }
+        }
+    });
+    // Most facets are far from a column
+    REQUIRE(totalCount < facets.size() * columnsCount / 4);
+}
@@ -0,0 +1,38 @@
+#include "geometry/entity/polytope.h"
+#include "grid/rasterization/facet_rasterizer.h"
+#include "tests/grid/helpers.h"
+
+#include <catch2/catch.hpp>
+
+TEST_CASE("scanning facet rasterizer")
+{
+    const auto polytope = Polytope::loadObj("examples/heart_320.obj");
+    const auto sampling = polytopeSampling(polytope, 32);
+    const auto sparse = sparseSampling(
+        sampling,
+        [] (const Coordinates& coordinates) {
+            return (coordinates[1] + coordinates[2]) % 4 != 0;
+        });
+
+    for (const auto* testSampling : {&sampling, &sparse}) {
+        const auto localGeometry =
+            testSampling->toLocal(polytope.facetGeometries());
+        REQUIRE(rasterizeFacets(
+            localGeometry, *testSampling, rasterizeFacetByScanning) ==
+            rasterizeFacets(
+                localGeometry, *testSampling, rasterizeFacetByOverlap));
+    }
+
+    // Large facet inclined to every axis
+    const Facet facet{
+        Point{1.3, 2.1, 3.7},
+        Point{29.8, 7.2, 14.1},
+        Point{6.4, 30.5, 25.9}};
+    const auto facetGeometry = Generator<const Facet&>(
+        [&] (auto&& yield) {
+            yield(facet);
+        });
+    REQUIRE(
+        rasterizeFacets(facetGeometry, sampling, rasterizeFacetByScanning) ==
+        rasterizeFacets(facetGeometry, sampling, rasterizeFacetByOverlap));
+}
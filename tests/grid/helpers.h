@@ -0,0 +1,77 @@
+#pragma once
+
+#include "geometry/entity/bounding_box.h"
+#include "geometry/entity/polytope.h"
+#include "grid/rasterization/facet_rasterizer.h"
+#include "grid/rasterization/polytope_rasterizer.h"
+#include "grid/sampling/vector_sampling.h"
+
+#include <vector>
+
+// Locations of the voxels in the raster order
+inline std::vector<Location> locations(const SparseRaster<Location>& raster)
+{
+    std::vector<Location> result;
+    raster.voxels().process([&] (const auto& voxel) {
+        result.push_back(voxel.value);
+    });
+    return result;
+}
+
+// Outer sampling of the grid over the polytope with a margin
+inline VectorSampling<Location> polytopeSampling(
+        const Polytope& polytope,
+        size_t gridSize)
+{
+    const Box container = boundingBox(polytope.vertices());
+    return {
+        {container.center(), container.radius() * 1.1},
+        gridSize,
+        Location::Outer};
+}
+
+// Outer sampling of the voxels satisfying the predicate
+template<class Predicate>
+VectorSampling<Location> sparseSampling(
+        const VectorSampling<Location>& sampling,
+        const Predicate& selected)
+{
+    return {
+        sampling,
+        VectorSparseRaster<Location>{
+            filterGenerator(
+                mapGenerator<const Coordinates&>(
+                    sampling.voxels(),
+                    [] (const auto& voxel) {
+                        return voxel.coordinates();
+                    }),
+                [&selected] (const Coordinates& coordinates) {
+                    return selected(coordinates);
+                }),
+            Location::Outer,
+            sampling.size()
+        }};
+}
+
+// Image locations of the facets given in local coordinates
+inline std::vector<Location> rasterizeFacets(
+        const Generator<const Facet&>& localGeometry,
+        const VectorSampling<Location>& sampling,
+        const FacetRasterizer& facetRasterizer)
+{
+    auto image = sampling;
+    localGeometry.process([&] (const Facet& facet) {
+        facetRasterizer(facet, &image);
+    });
+    return locations(image);
+}
+
+inline std::vector<Location> rasterizePolytope(
+        const Polytope& polytope,
+        const VectorSampling<Location>& sampling,
+        const PolytopeRasterizer& polytopeRasterizer)
+{
+    auto image = sampling;
+    polytopeRasterizer(image.toLocal(polytope.facetGeometries()), &image);
+    return locations(image);
+}
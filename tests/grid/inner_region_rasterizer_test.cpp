@@ -0,0 +1,67 @@
+#include "geometry/entity/polytope.h"
+#include "grid/rasterization/bbox_facet_rasterizer.h"
+#include "grid/rasterization/polytope_rasterizer.h"
+#include "tests/grid/helpers.h"
+
+#include <catch2/catch.hpp>
+
+#include <vector>
+
+namespace {
+
+std::vector<Location> rasterize(
+        const Polytope& polytope,
+        const VectorSampling<Location>& sampling,
+        InnerRegionRasterizer innerRegionRasterizer)
+{
+    return rasterizePolytope(
+        polytope,
+        sampling,
+        polytopeRasterizer(bBoxFacetRasterizer(), innerRegionRasterizer));
+}
+
+// Every facet is tested for every voxel
+void rasterizeInnerRegionDirectly(
+        const Generator<const Facet&>& localPolytopeGeometry,
+        SparseRaster<Location>* raster)
+{
+    raster->voxels().process([&] (auto& voxel) {
+        if (voxel.value == Location::Outer) {
+            voxel.value = locatePoint(
+                (voxel.coordinates().template cast<double>() +
+                    Point::constant(0.5)).eval(),
+                localPolytopeGeometry);
+        }
+    });
+}
+
+} // namespace
+
+TEST_CASE("inner region rasterizers agree")
+{
+    const auto polytope = Polytope::loadObj("examples/heart_320.obj");
+    const auto sampling = polytopeSampling(polytope, 24);
+    // Sparse selection with gaps inside the columns
+    const auto sparse = sparseSampling(
+        sampling,
+        [] (const Coordinates& coordinates) {
+            return (coordinates[0] + 2 * coordinates[2]) % 3 != 0;
+        });
+
+    for (const auto* testSampling : {&sampling, &sparse}) {
+        const auto expected = rasterize(
+            polytope, *testSampling, rasterizeInnerRegionDirectly);
+        REQUIRE(rasterize(
+            polytope, *testSampling, rasterizeInnerRegionSequentally) ==
+            expected);
+        REQUIRE(rasterize(
+            polytope, *testSampling, rasterizeInnerRegionByFacets) ==
+            expected);
+        REQUIRE(rasterize(
+            polytope, *testSampling, rasterizeInnerRegionByRays) ==
+            expected);
+        REQUIRE(rasterize(
+            polytope, *testSampling, rasterizeInnerRegionByComponents) ==
+            expected);
+    }
+}
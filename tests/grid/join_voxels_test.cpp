@@ -0,0 +1,64 @@
+#include "grid/sampling/vector_sparse_raster.h"
+
+#include <catch2/catch.hpp>
+
+#include <utility>
+#include <vector>
+
+TEST_CASE("join voxels")
+{
+    VectorSparseRaster<int> lhs{Coordinates::constant(4), 0};
+    VectorSparseRaster<int> rhs{
+        std::vector<Coordinates>{
+            {0, 0, 0}, {1, 2, 3}, {2, 1, 0}, {3, 3, 3}, {4, 1, 1}},
+        0};
+    int value = 0;
+    rhs.voxels().process([&] (auto& voxel) {
+        voxel.value = ++value;
+    });
+
+    const Coordinates offset{1, 0, 0};
+    size_t matchesCount = 0;
+    joinVoxels(
+        lhs.voxels(),
+        std::as_const(rhs).voxels(),
+        offset,
+        [&] (auto& voxel, const auto* matching) {
+            const auto* expected =
+                rhs.find((voxel.coordinates() + offset).eval());
+            REQUIRE(matching == expected);
+            if (matching) {
+                voxel.value = matching->value;
+                ++matchesCount;
+            }
+        });
+
+    REQUIRE(matchesCount == 4);
+    REQUIRE(lhs.find(Coordinates({0, 2, 3}))->value == 2);
+    REQUIRE(lhs.find(Coordinates({1, 1, 0}))->value == 3);
+    REQUIRE(lhs.find(Coordinates({2, 3, 3}))->value == 4);
+    REQUIRE(lhs.find(Coordinates({3, 1, 1}))->value == 5);
+
+    // Generated voxels are matched the same way
+    size_t generatedMatchesCount = 0;
+    joinVoxels(
+        lhs.voxels(),
+        filterGenerator(
+            std::as_const(rhs).voxels(),
+            [] (const auto& voxel) {
+                return voxel.value != 3;
+            }),
+        offset,
+        [&] (const auto& voxel, const auto* matching) {
+            const auto* expected =
+                rhs.find((voxel.coordinates() + offset).eval());
+            if (expected && expected->value == 3) {
+                expected = nullptr;
+            }
+            REQUIRE(matching == expected);
+            if (matching) {
+                ++generatedMatchesCount;
+            }
+        });
+    REQUIRE(generatedMatchesCount == 3);
+}
@@ -0,0 +1,72 @@
+#include "geometry/location/location.h"
+#include "grid/sampling/location_planes.h"
+#include "grid/sampling/vector_sparse_raster.h"
+
+#include <catch2/catch.hpp>
+
+#include <random>
+
+TEST_CASE("location planes")
+{
+    std::mt19937 random(3);
+    std::uniform_int_distribution<int> location(0, 2);
+
+    VectorSparseRaster<Location> lhs{Coordinates({5, 6, 7}), Location::Outer};
+    VectorSparseRaster<Location> rhs{Coordinates({5, 6, 7}), Location::Outer};
+    for (auto* raster : {&lhs, &rhs}) {
+        raster->voxels().process([&] (auto& voxel) {
+            voxel.value = static_cast<Location>(location(random));
+        });
+    }
+
+    const auto box = LocationPlanes::preferableBox(lhs);
+    REQUIRE(box);
+    REQUIRE(box->first == Coordinates({0, 0, 0}));
+    REQUIRE(box->second == Coordinates({4, 5, 6}));
+
+    LocationPlanes lhsPlanes(box->first, box->second);
+    lhsPlanes.assign(lhs);
+    LocationPlanes rhsPlanes(box->first, box->second);
+    rhsPlanes.assign(rhs);
+
+    lhs.voxels().process([&] (const auto& voxel) {
+        REQUIRE(lhsPlanes.location(voxel.coordinates()) == voxel.value);
+    });
+    REQUIRE(lhsPlanes.location(Coordinates({5, 0, 0})) == Location::Outer);
+
+    lhsPlanes.unite(rhsPlanes);
+    auto united = rhs;
+    lhsPlanes.commit(&united, [] (Location* value, Location imageValue) {
+        *value = imageValue;
+    });
+    united.voxels().process([&] (const auto& voxel) {
+        const auto lhsValue = lhs.find(voxel.coordinates())->value;
+        const auto rhsValue = rhs.find(voxel.coordinates())->value;
+        if (lhsValue == Location::Inner || rhsValue == Location::Inner) {
+            REQUIRE(voxel.value == Location::Inner);
+        } else if (lhsValue == Location::Boundary ||
+                rhsValue == Location::Boundary) {
+            REQUIRE(voxel.value == Location::Boundary);
+        } else {
+            REQUIRE(voxel.value == Location::Outer);
+        }
+    });
+
+    // Reset planes of another box are empty
+    lhsPlanes.reset(Coordinates({1, 1, 1}), Coordinates({2, 3, 4}));
+    REQUIRE(lhsPlanes.min() == Coordinates({1, 1, 1}));
+    REQUIRE(lhsPlanes.max() == Coordinates({2, 3, 4}));
+    lhs.voxels().process([&] (const auto& voxel) {
+        REQUIRE(lhsPlanes.location(voxel.coordinates()) == Location::Outer);
+    });
+    lhsPlanes.assign(rhs);
+    REQUIRE(lhsPlanes.location(Coordinates({2, 3, 4})) ==
+        rhs.find(Coordinates({2, 3, 4}))->value);
+    REQUIRE(lhsPlanes.location(Coordinates({0, 3, 4})) == Location::Outer);
+
+    // Sparse selections are better kept as they are
+    const VectorSparseRaster<Location> sparse{
+        std::vector<Coordinates>{{0, 0, 0}, {20, 20, 20}},
+        Location::Inner};
+    REQUIRE(!LocationPlanes::preferableBox(sparse));
+}
@@ -26,3 +26,23 @@ TEST_CASE("mapper")
     REQUIRE(test3[1] == Approx(18.75).epsilon(1e-9));
     REQUIRE(test3[2] == Approx(-7.5).epsilon(1e-9));
 }
+
+TEST_CASE("mapper alignment")
+{
+    Mapper mapper(Box({2., 3., 4.}, 2.), 16);
+
+    Mapper shifted(Box({2.75, 2.5, 4.}, 1.), 8);
+    auto offset = alignmentOffset(shifted, mapper);
+    REQUIRE(offset);
+    REQUIRE(*offset == Coordinates({7, 2, 4}));
+
+    REQUIRE(!alignmentOffset(Mapper(Box({2.1, 3., 4.}, 1.), 8), mapper));
+    REQUIRE(!alignmentOffset(Mapper(Box({2., 3., 4.}, 2.), 32), mapper));
+
+    // Steps are compared relatively to their size
+    const Mapper coarse(Box({0., 0., 0.}, 8e6), 16);
+    REQUIRE(alignmentOffset(
+        Mapper(Box({0., 0., 0.}, 8e6 * (1. + 1e-12)), 16), coarse));
+    const Mapper fine(Box({0., 0., 0.}, 8e-12), 16);
+    REQUIRE(!alignmentOffset(Mapper(Box({0., 0., 0.}, 8e-12), 8), fine));
+}
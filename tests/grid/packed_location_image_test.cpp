@@ -0,0 +1,121 @@
+#include "geometry/location/location.h"
+#include "grid/sampling/packed_location_image.h"
+#include "grid/sampling/vector_sampling.h"
+
+#include <catch2/catch.hpp>
+
+#include <random>
+#include <utility>
+#include <vector>
+
+namespace {
+
+void requireSameImage(
+        const PackedLocationImage& image,
+        VectorSampling<Location>* sampling)
+{
+    REQUIRE(image.size() == sampling->size());
+
+    std::vector<std::pair<Coordinates, Location>> expected;
+    sampling->voxels().process([&] (const auto& voxel) {
+        expected.emplace_back(voxel.coordinates(), voxel.value);
+    });
+    std::vector<std::pair<Coordinates, Location>> actual;
+    image.process([&] (const Coordinates& coordinates, Location location) {
+        actual.emplace_back(coordinates, location);
+    });
+    REQUIRE(actual == expected);
+
+    // Shifted copies of the voxels are matched by their coordinates
+    for (const auto& offset : {
+            Coordinates({0, 0, 0}),
+            Coordinates({1, -2, 3}),
+            Coordinates({-5, 0, 0})}) {
+        image.join(
+            std::as_const(*sampling).voxels(),
+            offset,
+            [&] (const auto& voxel, const Location* location) {
+                const auto* matching = sampling->find(
+                    (voxel.coordinates() + offset).eval());
+                REQUIRE(bool(location) == bool(matching));
+                if (location) {
+                    REQUIRE(*location == matching->value);
+                }
+            });
+    }
+}
+
+} // namespace
+
+TEST_CASE("packed location image")
+{
+    std::mt19937 random(5);
+    std::uniform_int_distribution<int> location(0, 2);
+    std::bernoulli_distribution selected(0.02);
+
+    std::vector<Coordinates> selection;
+    VectorSampling<Location>{Box{{0., 0., 0.}, 1.}, 24, Location::Outer}
+        .voxels().process([&] (const auto& voxel) {
+            if (selected(random)) {
+                selection.push_back(voxel.coordinates());
+            }
+        });
+    VectorSampling<Location> sampling{
+        Mapper{Box{{0., 0., 0.}, 1.}, 24},
+        VectorSparseRaster<Location>::fromSorted(selection, Location::Outer)
+    };
+    sampling.voxels().process([&] (auto& voxel) {
+        voxel.value = static_cast<Location>(location(random));
+    });
+
+    const PackedLocationImage image(sampling);
+    REQUIRE(!image.dense());
+    REQUIRE(image.gridSize() == sampling.gridSize());
+    requireSameImage(image, &sampling);
+}
+
+TEST_CASE("packed location image of dense sampling")
+{
+    std::mt19937 random(6);
+    std::uniform_int_distribution<int> location(0, 2);
+    std::bernoulli_distribution selected(0.9);
+
+    // Box of the voxels is not the raster one
+    std::vector<Coordinates> selection;
+    VectorSampling<Location>{Box{{0., 0., 0.}, 1.}, 16, Location::Outer}
+        .voxels().process([&] (const auto& voxel) {
+            const auto& coordinates = voxel.coordinates();
+            if (coordinates[0] >= 3 && coordinates[1] < 13 &&
+                    selected(random)) {
+                selection.push_back(coordinates);
+            }
+        });
+    VectorSampling<Location> sampling{
+        Mapper{Box{{0., 0., 0.}, 1.}, 16},
+        VectorSparseRaster<Location>::fromSorted(selection, Location::Outer)
+    };
+    sampling.voxels().process([&] (auto& voxel) {
+        voxel.value = static_cast<Location>(location(random));
+    });
+
+    const PackedLocationImage image(sampling);
+    REQUIRE(image.dense());
+    requireSameImage(image, &sampling);
+}
+
+TEST_CASE("packed location image of stretched box")
+{
+    // Coordinates do not fit the keys, so they are kept as they are
+    const int far = 1 << 29;
+    const std::vector<Coordinates> selection{
+        {0, 0, 0}, {0, far, 7}, {far, 0, far}, {far, far, far}};
+    VectorSampling<Location> sampling{
+        Mapper{Box{{0., 0., 0.}, 1.}, static_cast<size_t>(far) + 1},
+        VectorSparseRaster<Location>::fromSorted(selection, Location::Inner)
+    };
+    sampling.find(Coordinates({0, far, 7}))->value = Location::Boundary;
+
+    const PackedLocationImage image(sampling);
+    REQUIRE(!image.dense());
+    requireSameImage(image, &sampling);
+}
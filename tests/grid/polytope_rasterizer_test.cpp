@@ -0,0 +1,32 @@
+#include "geometry/entity/polytope.h"
+#include "grid/rasterization/polytope_rasterizer.h"
+#include "tests/grid/helpers.h"
+
+#include <catch2/catch.hpp>
+
+#include <string>
+
+TEST_CASE("fused polytope rasterizer")
+{
+    const auto reference = polytopeRasterizer(
+        rasterizeFacetByOverlap, rasterizeInnerRegionByRays);
+
+    for (const std::string name : {"heart_320", "box_12"}) {
+        const auto polytope = Polytope::loadObj("examples/" + name + ".obj");
+        const auto sampling = polytopeSampling(polytope, 20);
+        // Sparse selection with gaps inside the columns
+        const auto sparse = sparseSampling(
+            sampling,
+            [] (const Coordinates& coordinates) {
+                return (coordinates[1] + 2 * coordinates[2]) % 3 != 0;
+            });
+
+        for (const auto* testSampling : {&sampling, &sparse}) {
+            const auto expected =
+                rasterizePolytope(polytope, *testSampling, reference);
+            REQUIRE(rasterizePolytope(
+                polytope, *testSampling, rasterizePolytopeByColumns) ==
+                expected);
+        }
+    }
+}
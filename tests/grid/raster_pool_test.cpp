@@ -0,0 +1,95 @@
+#include "grid/sampling/raster_pool.h"
+#include "grid/sampling/refinement.h"
+#include "grid/sampling/vector_sampling.h"
+#include "tests/geometry/helpers.h"
+
+#include <catch2/catch.hpp>
+
+#include <utility>
+#include <vector>
+
+namespace {
+
+std::vector<std::pair<Coordinates, Location>> contents(
+        const VectorSampling<Location>& sampling)
+{
+    std::vector<std::pair<Coordinates, Location>> result;
+    sampling.voxels().process([&] (const auto& voxel) {
+        result.emplace_back(voxel.coordinates(), voxel.value);
+    });
+    return result;
+}
+
+} // namespace
+
+TEST_CASE("raster pool storage reuse")
+{
+    RasterPool<Location> pool;
+    REQUIRE(pool.spareCount() == 0);
+
+    auto small = pool.acquire(10);
+    auto large = pool.acquire(100);
+    REQUIRE(small.capacity() >= 10);
+    REQUIRE(large.capacity() >= 100);
+    small.emplace_back(Coordinates::constant(1), Location::Inner);
+    const auto* smallData = small.data();
+
+    pool.recycle(std::move(large));
+    pool.recycle(std::move(small));
+    // Storages without a capacity are not kept
+    pool.recycle(RasterPool<Location>::Storage{});
+    REQUIRE(pool.spareCount() == 2);
+
+    // The smallest fitting one is taken and comes empty
+    auto fitting = pool.acquire(5);
+    REQUIRE(fitting.data() == smallData);
+    REQUIRE(fitting.empty());
+
+    // The largest one is grown when none fits
+    pool.recycle(std::move(fitting));
+    auto grown = pool.acquire(1000);
+    REQUIRE(grown.capacity() >= 1000);
+    REQUIRE(pool.spareCount() == 1);
+
+    auto raster = VectorSparseRaster<Location>::fromSortedVoxels(
+        pool.acquire(1));
+    REQUIRE(pool.spareCount() == 0);
+    pool.recycle(&raster);
+    REQUIRE(raster.size() == 0);
+    REQUIRE(pool.spareCount() == 1);
+}
+
+TEST_CASE("pooled shrink and refine")
+{
+    VectorSampling<Location> sampling{Box{{0, 1, 0}, 4.}, 16, Location::Outer};
+    sampling.find(Coordinates({2,7,11}))->value = Location::Boundary;
+    sampling.find(Coordinates({2,7,12}))->value = Location::Boundary;
+    sampling.find(Coordinates({2,8,11}))->value = Location::Inner;
+    sampling.find(Coordinates({14,10,3}))->value = Location::Inner;
+    sampling.find(Coordinates({14,12,3}))->value = Location::Inner;
+
+    RasterPool<Location> pool;
+
+    const auto expectedShrunk = shrink(sampling);
+    auto shrunk = shrink(sampling, &pool);
+    REQUIRE(shrunk.gridSize() == expectedShrunk.gridSize());
+    REQUIRE(pointsEqual(
+        shrunk.container().center(), expectedShrunk.container().center()));
+    REQUIRE(contents(shrunk) == contents(expectedShrunk));
+
+    const auto expectedRefined = refine(shrunk);
+    auto refined = refine(shrunk, &pool);
+    REQUIRE(refined.gridSize() == expectedRefined.gridSize());
+    REQUIRE(contents(refined) == contents(expectedRefined));
+    // Parents storage is returned to the pool
+    REQUIRE(pool.spareCount() == 1);
+
+    // Recycled storages are reused for the next rasters
+    const auto shrunkSize = shrunk.size();
+    pool.recycle(&shrunk);
+    pool.recycle(&refined);
+    REQUIRE(pool.spareCount() == 3);
+    const auto reshrunk = shrink(expectedRefined, &pool);
+    REQUIRE(pool.spareCount() == 2);
+    REQUIRE(reshrunk.size() == shrunkSize * 8);
+}
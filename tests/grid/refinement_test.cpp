@@ -1,9 +1,14 @@
 #include "grid/sampling/refinement.h"
 #include "grid/sampling/vector_sampling.h"
+#include "grid/sampling/xd_iterator.h"
 #include "tests/geometry/helpers.h"
 
 #include <catch2/catch.hpp>
 
+#include <algorithm>
+#include <utility>
+#include <vector>
+
 // TODO: Shrink test with boundary conditions
 TEST_CASE("vector sampling refinement")
 {
@@ -47,3 +52,37 @@ TEST_CASE("vector sampling refinement")
     REQUIRE(innerCount == 0);
     REQUIRE(outerCount == 0);
 }
+
+TEST_CASE("refined voxels order")
+{
+    const std::vector<Coordinates> coordinates{
+        {0, 0, 0}, {0, 0, 3}, {0, 2, 1}, {1, 0, 0}, {1, 1, 1}, {4, 0, 2}};
+    std::vector<Voxel<Location>> parents;
+    for (size_t i = 0; i < coordinates.size(); ++i) {
+        parents.emplace_back(
+            coordinates[i], static_cast<Location>(i % 3));
+    }
+
+    std::vector<std::pair<Coordinates, Location>> expected;
+    for (const auto& parent : parents) {
+        XDIterator<DIMS>::run(
+            Coordinates::constant(REFINEMENT_SCALE),
+            [&] (const Coordinates& offset) {
+                expected.emplace_back(
+                    (parent.coordinates() * REFINEMENT_SCALE + offset).eval(),
+                    parent.value);
+            });
+    }
+    std::sort(expected.begin(), expected.end(), [] (
+            const auto& lhs, const auto& rhs) {
+        return preceding(lhs.first, rhs.first);
+    });
+
+    std::vector<Voxel<Location>> children;
+    appendRefinedVoxels(parents, &children);
+    std::vector<std::pair<Coordinates, Location>> actual;
+    for (const auto& child : children) {
+        actual.emplace_back(child.coordinates(), child.value);
+    }
+    REQUIRE(actual == expected);
+}
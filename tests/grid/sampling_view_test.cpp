@@ -0,0 +1,81 @@
+#include "geometry/location/location.h"
+#include "grid/sampling/raster_pool.h"
+#include "grid/sampling/sampling_view.h"
+#include "grid/sampling/vector_sampling.h"
+
+#include <catch2/catch.hpp>
+
+TEST_CASE("sampling view")
+{
+    VectorSampling<Location> sampling{Box{{0, 1, 0}, 4.}, 4, Location::Outer};
+    sampling.find(Coordinates({1,2,3}))->value = Location::Inner;
+    sampling.find(Coordinates({2,2,2}))->value = Location::Boundary;
+
+    SamplingView<Location> view(
+        &sampling,
+        [] (Location value) {
+            return value != Location::Inner;
+        },
+        Location::Outer);
+
+    REQUIRE(view.size() == 63);
+    REQUIRE(view.gridStep() == Approx(sampling.gridStep()));
+    REQUIRE(view.find(Coordinates({1,2,3})) == nullptr);
+    REQUIRE(view.find(Coordinates({2,2,2}))->value == Location::Outer);
+
+    const auto combine = [] (Location* parentValue, Location viewValue) {
+        if (viewValue != Location::Outer) {
+            *parentValue = viewValue;
+        }
+    };
+
+    view.find(Coordinates({0,0,0}))->value = Location::Inner;
+    view.find(Coordinates({3,3,3}))->value = Location::Boundary;
+    view.commit(combine);
+
+    REQUIRE(view.size() == 62);
+    REQUIRE(view.find(Coordinates({0,0,0})) == nullptr);
+    REQUIRE(view.find(Coordinates({3,3,3}))->value == Location::Boundary);
+    REQUIRE(sampling.find(Coordinates({0,0,0}))->value == Location::Inner);
+    REQUIRE(sampling.find(Coordinates({3,3,3}))->value == Location::Boundary);
+    REQUIRE(sampling.find(Coordinates({2,2,2}))->value == Location::Boundary);
+
+    view.fill(Location::Outer);
+    size_t outerCount = 0;
+    Coordinates previous = Coordinates::constant(-1);
+    bool sorted = true;
+    view.voxels().process([&] (const auto& voxel) {
+        sorted = sorted && preceding(previous, voxel.coordinates());
+        previous = voxel.coordinates();
+        if (voxel.value == Location::Outer) {
+            ++outerCount;
+        }
+    });
+    REQUIRE(sorted);
+    REQUIRE(outerCount == 62);
+
+    view.commit(combine);
+    REQUIRE(view.size() == 62);
+    REQUIRE(sampling.find(Coordinates({3,3,3}))->value == Location::Boundary);
+}
+
+TEST_CASE("sampling view storage from a pool")
+{
+    VectorSampling<Location> sampling{Box{{0, 1, 0}, 4.}, 4, Location::Outer};
+    const auto selectAll = [] (Location /*value*/) {
+        return true;
+    };
+
+    RasterPool<Location> pool;
+    pool.recycle(pool.acquire(sampling.size()));
+    REQUIRE(pool.spareCount() == 1);
+
+    SamplingView<Location> view(
+        &sampling, selectAll, Location::Inner, &pool);
+    REQUIRE(pool.spareCount() == 0);
+    REQUIRE(view.size() == sampling.size());
+
+    recycleStorage(&pool, &view);
+    REQUIRE(pool.spareCount() == 1);
+    REQUIRE(view.size() == 0);
+}
@@ -0,0 +1,37 @@
+#include "grid/sampling/vector_sparse_raster.h"
+
+#include <catch2/catch.hpp>
+
+#include <algorithm>
+#include <limits>
+#include <vector>
+
+TEST_CASE("vector sparse raster construction")
+{
+    std::vector<Coordinates> selection{
+        {3, 1, 2}, {0, 5, 1}, {-2, 7, 0}, {3, 1, 2}, {0, 5, 0}, {3, 0, 9}};
+
+    const auto sortedCoordinates = [] (const VectorSparseRaster<int>& raster) {
+        std::vector<Coordinates> result;
+        raster.voxels().process([&] (const auto& voxel) {
+            result.push_back(voxel.coordinates());
+        });
+        return result;
+    };
+    const auto expected = [] (std::vector<Coordinates> selection) {
+        std::sort(selection.begin(), selection.end(), preceding);
+        selection.erase(
+            std::unique(selection.begin(), selection.end()),
+            selection.end());
+        return selection;
+    };
+
+    REQUIRE(sortedCoordinates(VectorSparseRaster<int>{selection, 1}) ==
+        expected(selection));
+
+    // Coordinates not fitting the packed keys
+    selection.push_back({0, std::numeric_limits<int>::max(), 0});
+    selection.push_back({std::numeric_limits<int>::min(), 0, 0});
+    REQUIRE(sortedCoordinates(VectorSparseRaster<int>{selection, 1}) ==
+        expected(selection));
+}
@@ -0,0 +1,102 @@
+#include "grid/rasterization/polytope_rasterizer.h"
+#include "grid/sampling/raster_pool.h"
+#include "grid/sampling/refinement.h"
+#include "solver/inverse/domain_estimator.h"
+#include "tests/solver/helpers.h"
+
+#include <catch2/catch.hpp>
+
+#include <algorithm>
+#include <vector>
+
+namespace {
+
+DomainEstimatorFactory estimatorFactory()
+{
+    return graphicDomainEstimatorFactory(
+        referenceMSRasterizer(),
+        polytopeRasterizer(
+            rasterizeFacetByOverlap, rasterizeInnerRegionByRays));
+}
+
+} // namespace
+
+TEST_CASE("domain estimator reuses its images")
+{
+    const ExampleSum example("heart_320", "box_12");
+    const auto factory = estimatorFactory();
+
+    RasterPool<Location> pool;
+    auto estimator = factory(&example.sum, &example.contour, &pool);
+
+    // Every estimation is the one of an estimator made for it
+    const auto estimate = [&] (
+            const VectorSampling<Location>& sampling,
+            double radius) {
+        auto result = estimator(sampling, radius);
+        const auto expected = factory(
+            &example.sum, &example.contour, nullptr)(sampling, radius);
+        REQUIRE(locations(result) == locations(expected));
+        return result;
+    };
+
+    // The results are given back to the pool as the solver does
+    const auto check = [&] (
+            const VectorSampling<Location>& sampling,
+            double radius) {
+        auto result = estimate(sampling, radius);
+        pool.recycle(&result);
+    };
+
+    const auto sampling = polytopeSampling(example.contour, 16);
+    // Growing radii on the same grid
+    for (double radius : {0.1, 0.15, 0.25}) {
+        check(sampling, radius);
+    }
+
+    // The grid is kept for a shrunk sampling
+    auto domain = estimate(sampling, 0.3);
+    const auto shrunk = shrink(domain);
+    pool.recycle(&domain);
+    REQUIRE(alignmentOffset(shrunk, sampling));
+    check(shrunk, 0.3);
+    domain = estimate(shrunk, 0.35);
+
+    // A refined sampling inherits the contour image
+    const auto refined = refine(domain);
+    pool.recycle(&domain);
+    check(refined, 0.35);
+
+    // A smaller radius does not take the inner voxels
+    const auto domainLocations = locations(estimate(refined, 0.2));
+    REQUIRE(std::count(
+        domainLocations.begin(), domainLocations.end(),
+        Location::Inner) > 0);
+}
+
+TEST_CASE("domain estimator of a covered sampling")
+{
+    const ExampleSum example("heart_320", "box_12");
+    auto estimator = estimatorFactory()(
+        &example.sum, &example.contour, nullptr);
+
+    // The sum covers the whole container at a large radius
+    const Box container = boundingBox(example.contour.vertices());
+    const VectorSampling<Location> covered{
+        {container.center(), container.radius() * 0.1},
+        8,
+        Location::Boundary};
+    const auto domain = locations(
+        estimator(covered, container.radius() * 4.));
+    REQUIRE(std::all_of(
+        domain.begin(), domain.end(),
+        [] (Location location) {
+            return location == Location::Outer;
+        }));
+
+    // The contour image is still made for the next sampling
+    const auto sampling = polytopeSampling(example.contour, 16);
+    REQUIRE(locations(estimator(sampling, 0.2)) == locations(
+        estimatorFactory()(
+            &example.sum, &example.contour, nullptr)(sampling, 0.2)));
+}
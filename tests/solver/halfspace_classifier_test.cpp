@@ -0,0 +1,195 @@
+#include "solver/inverse/halfspace_classifier.h"
+
+#include <catch2/catch.hpp>
+
+#include <array>
+#include <cmath>
+#include <random>
+#include <vector>
+
+namespace {
+
+void addHalfspace(
+        LocalHalfspaces* halfspaces,
+        const Vector<>& normal,
+        double offset)
+{
+    for (size_t i = 0; i < DIMS; ++i) {
+        halfspaces->normals[i].push_back(normal[i]);
+        halfspaces->lowestPoints[i].push_back(normal[i] < -MEPS ? 1. : 0.);
+    }
+    halfspaces->offsets.push_back(offset);
+    halfspaces->sizeProjections.push_back(normal.cwiseAbs().sum());
+}
+
+// Distance to the first halfspace rounded operation by operation
+// or with the products fused into the sums
+double roundedDistance(
+        const LocalHalfspaces& halfspaces,
+        const std::array<double, DIMS>& voxel,
+        bool fused)
+{
+    std::array<double, DIMS> shifted;
+    for (size_t i = 0; i < DIMS; ++i) {
+        shifted[i] = voxel[i] + halfspaces.lowestPoints[i][0];
+    }
+    if (fused) {
+        const double sum = std::fma(halfspaces.normals[1][0], shifted[1],
+            halfspaces.normals[0][0] * shifted[0]);
+        return std::fma(halfspaces.normals[2][0], shifted[2], sum) -
+            halfspaces.offsets[0];
+    }
+
+    // Stores are not contracted whatever the compiler flags are
+    volatile double dx = halfspaces.normals[0][0] * shifted[0];
+    volatile double dy = halfspaces.normals[1][0] * shifted[1];
+    volatile double dz = halfspaces.normals[2][0] * shifted[2];
+    volatile double sum = dx + dy;
+    sum = sum + dz;
+    return sum - halfspaces.offsets[0];
+}
+
+Location location(const LocalHalfspaces& halfspaces, double distance)
+{
+    if (distance > MEPS) {
+        return Location::Outer;
+    } else if (distance + halfspaces.sizeProjections[0] > -MEPS) {
+        return Location::Boundary;
+    }
+    return Location::Inner;
+}
+
+} // namespace
+
+TEST_CASE("halfspace classifier box")
+{
+    // Box [0.5, 3.5]^3
+    LocalHalfspaces halfspaces;
+    for (size_t i = 0; i < DIMS; ++i) {
+        addHalfspace(&halfspaces, Vector<>::Unit(i), 3.5);
+        addHalfspace(&halfspaces, -Vector<>::Unit(i), -0.5);
+    }
+
+    VoxelCorners corners;
+    std::vector<Location> expected;
+    for (int x = 0; x < 5; ++x) {
+        for (int y = 0; y < 5; ++y) {
+            for (int z = 0; z < 5; ++z) {
+                corners[0].push_back(x);
+                corners[1].push_back(y);
+                corners[2].push_back(z);
+
+                const auto inside = [] (int c) {
+                    return c >= 1 && c < 3;
+                };
+                const auto touching = [] (int c) {
+                    return c >= 0 && c <= 3;
+                };
+                if (inside(x) && inside(y) && inside(z)) {
+                    expected.push_back(Location::Inner);
+                } else if (touching(x) && touching(y) && touching(z)) {
+                    expected.push_back(Location::Boundary);
+                } else {
+                    expected.push_back(Location::Outer);
+                }
+            }
+        }
+    }
+
+    for (auto level : {SimdLevel::Scalar, SimdLevel::AVX2, SimdLevel::AVX512}) {
+        std::vector<Location> locations(expected.size());
+        classifyVoxels(halfspaces, corners, locations.data(), level);
+        REQUIRE(locations == expected);
+    }
+}
+
+TEST_CASE("halfspace classifier levels agree")
+{
+    std::mt19937 generator(42);
+    std::uniform_real_distribution<double> coordinate(-1., 1.);
+    std::uniform_int_distribution<int> corner(0, 20);
+
+    // Random tangent planes of a ball
+    LocalHalfspaces halfspaces;
+    for (size_t j = 0; j < 40; ++j) {
+        Vector<> normal{coordinate(generator), coordinate(generator),
+            coordinate(generator)};
+        normal.normalize();
+        addHalfspace(&halfspaces, normal,
+            normal.dot(Vector<>::Constant(10.)) + 7.);
+    }
+    // Voxel faces lie exactly on this one
+    addHalfspace(&halfspaces, Vector<>::Unit(0), 15.);
+
+    VoxelCorners corners;
+    for (size_t i = 0; i < 1003; ++i) {
+        for (auto& axisCorners : corners) {
+            axisCorners.push_back(corner(generator));
+        }
+    }
+
+    std::vector<Location> expected(corners[0].size());
+    classifyVoxels(halfspaces, corners, expected.data(), SimdLevel::Scalar);
+    size_t boundaryCount = 0;
+    for (auto location : expected) {
+        boundaryCount += location == Location::Boundary;
+    }
+    REQUIRE(boundaryCount > 0);
+
+    for (auto level : {SimdLevel::AVX2, SimdLevel::AVX512}) {
+        std::vector<Location> locations(expected.size());
+        classifyVoxels(halfspaces, corners, locations.data(), level);
+        REQUIRE(locations == expected);
+    }
+}
+
+TEST_CASE("halfspace classifier rounding at thresholds")
+{
+    std::mt19937 generator(7);
+    std::uniform_real_distribution<double> coordinate(-1., 1.);
+    std::uniform_int_distribution<int> corner(0, 20);
+
+    size_t sensitiveCount = 0;
+    for (size_t k = 0; k < 200; ++k) {
+        Vector<> normal{coordinate(generator), coordinate(generator),
+            coordinate(generator)};
+        normal.normalize();
+        LocalHalfspaces halfspaces;
+        addHalfspace(&halfspaces, normal, 0.);
+        const std::array<double, DIMS> voxel{
+            double(corner(generator)),
+            double(corner(generator)),
+            double(corner(generator))};
+
+        // Distances land within an ulp of the product sum from ±MEPS
+        const double threshold = k % 2 == 0 ?
+            MEPS : -MEPS - halfspaces.sizeProjections[0];
+        halfspaces.offsets[0] =
+            roundedDistance(halfspaces, voxel, false) - threshold;
+
+        const auto expected = location(
+            halfspaces, roundedDistance(halfspaces, voxel, false));
+        if (location(halfspaces, roundedDistance(halfspaces, voxel, true)) !=
+                expected) {
+            ++sensitiveCount;
+        }
+
+        // Whole blocks of every level and the scalar tail
+        VoxelCorners corners;
+        for (size_t i = 0; i < 9; ++i) {
+            for (size_t axis = 0; axis < DIMS; ++axis) {
+                corners[axis].push_back(voxel[axis]);
+            }
+        }
+        for (auto level :
+                {SimdLevel::Scalar, SimdLevel::AVX2, SimdLevel::AVX512}) {
+            std::vector<Location> locations(corners[0].size());
+            classifyVoxels(halfspaces, corners, locations.data(), level);
+            for (auto result : locations) {
+                REQUIRE(result == expected);
+            }
+        }
+    }
+    // Fused products would flip these
+    REQUIRE(sensitiveCount > 0);
+}
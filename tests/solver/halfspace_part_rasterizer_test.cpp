@@ -0,0 +1,35 @@
+#include "solver/inverse/halfspace_part_rasterizer.h"
+#include "tests/solver/helpers.h"
+
+#include <catch2/catch.hpp>
+
+#include <algorithm>
+
+TEST_CASE("block-culling part rasterizer")
+{
+    const auto example = tetrahedronBoxSum();
+    const auto sampling = tetrahedronBoxSampling(48);
+    // Sparse selection with gaps inside the blocks
+    const auto sparse = sparseSampling(
+        sampling,
+        [] (const Coordinates& coordinates) {
+            return (coordinates[0] + coordinates[1]) % 5 != 0;
+        });
+
+    const auto reference = referenceMSRasterizer();
+    const auto blockRasterizer = decomposingMSRasterizer(rasterizePartByBlocks);
+
+    for (const auto* testSampling : {&sampling, &sparse}) {
+        for (double scale : {0.05, 0.2, 0.4}) {
+            const auto expectedLocations =
+                imageLocations(reference, example.sum, scale, *testSampling);
+            REQUIRE(
+                imageLocations(
+                    blockRasterizer, example.sum, scale, *testSampling) ==
+                expectedLocations);
+            REQUIRE(std::count(
+                expectedLocations.begin(), expectedLocations.end(),
+                Location::Inner) > 0);
+        }
+    }
+}
@@ -0,0 +1,72 @@
+#pragma once
+
+#include "geometry/convex_decomposition/convex_decomposition.h"
+#include "geometry/entity/polytope.h"
+#include "grid/sampling/refinement.h"
+#include "grid/sampling/vector_sampling.h"
+#include "solver/inverse/halfspace_part_rasterizer.h"
+#include "solver/inverse/minkowski_sum.h"
+#include "solver/inverse/minkowski_sum_rasterizer.h"
+#include "tests/grid/helpers.h"
+#include "utility/noncopyable.h"
+
+#include <string>
+#include <vector>
+
+// Sum of the example contour and the convex example pattern
+struct ExampleSum : public NonCopyable {
+    ExampleSum(const std::string& contourName, const std::string& patternName)
+        : contour(Polytope::loadObj("examples/" + contourName + ".obj"))
+        , pattern(Polytope::loadObj("examples/" + patternName + ".obj"))
+        , sum(contour, dummyDecomposition(&pattern))
+    {}
+
+    const Polytope contour;
+    const Polytope pattern;
+    const MinkowskiSum sum;
+};
+
+// Sum of the tetrahedron and the box
+inline ExampleSum tetrahedronBoxSum()
+{
+    return {"tetrahedron_4", "box_12"};
+}
+
+// Outer sampling around the tetrahedron and the box sum
+inline VectorSampling<Location> tetrahedronBoxSampling(size_t gridSize)
+{
+    return {Box({0., 0.25, -0.5}, 1.1), gridSize, Location::Outer};
+}
+
+inline MinkowskiSumRasterizer referenceMSRasterizer()
+{
+    return decomposingMSRasterizer(rasterizePartByHalfspaces);
+}
+
+// Image locations of the scaled sum
+inline std::vector<Location> imageLocations(
+        const MinkowskiSumRasterizer& msRasterizer,
+        const MinkowskiSum& sum,
+        double scale,
+        const VectorSampling<Location>& sampling)
+{
+    auto image = sampling;
+    msRasterizer(sum, scale, &image);
+    return locations(image);
+}
+
+// Shrunk sampling of the voxels not inside the image
+// as the domain estimation makes it
+inline VectorSampling<Location> shrunkOutsideImage(
+        const MinkowskiSum& sum,
+        double scale,
+        const VectorSampling<Location>& sampling)
+{
+    auto image = sampling;
+    referenceMSRasterizer()(sum, scale, &image);
+    image.voxels().process([] (auto& voxel) {
+        voxel.value = voxel.value == Location::Inner ?
+            Location::Outer : Location::Boundary;
+    });
+    return shrink(image);
+}
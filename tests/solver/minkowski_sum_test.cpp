@@ -0,0 +1,81 @@
+#include "geometry/convex_decomposition/convex_decomposition.h"
+#include "geometry/entity/polytope.h"
+#include "solver/inverse/minkowski_sum.h"
+
+#include <catch2/catch.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+TEST_CASE("minkowski sum halfspaces")
+{
+    const auto contour = Polytope::loadObj("examples/tetrahedron_4.obj");
+    const auto pattern = Polytope::loadObj("examples/box_12.obj");
+    const MinkowskiSum minkowskiSum(contour, dummyDecomposition(&pattern));
+    REQUIRE(minkowskiSum.convexPartsCount() == 4);
+
+    for (double patternScale : {0.25, 1., 3.}) {
+        minkowskiSum.convexParts(patternScale).process([&] (const auto& part) {
+            const auto& halfspaces = part.halfspaces;
+            REQUIRE(halfspaces.size() > 0);
+
+            const auto signedDistance = [&] (size_t j, const Point& point) {
+                double result = -(halfspaces.offsets0[j] +
+                    patternScale * halfspaces.offsetSlopes[j]);
+                for (size_t i = 0; i < DIMS; ++i) {
+                    result += halfspaces.normals[i][j] * point[i];
+                }
+                return result;
+            };
+
+            part.facets.process([&] (const Facet& facet) {
+                // Every facet lies on one of the bounding planes
+                bool supported = false;
+                for (size_t j = 0; j < halfspaces.size(); ++j) {
+                    bool onPlane = true;
+                    for (const auto& vertex : facet) {
+                        const auto distance = signedDistance(j, vertex);
+                        REQUIRE(distance < 1e-9);
+                        onPlane = onPlane && std::fabs(distance) < 1e-9;
+                    }
+                    supported = supported || onPlane;
+                }
+                REQUIRE(supported);
+
+                for (const auto& vertex : facet) {
+                    for (size_t i = 0; i < DIMS; ++i) {
+                        REQUIRE(vertex[i] >= part.boundingBox.min()[i] - 1e-9);
+                        REQUIRE(vertex[i] <= part.boundingBox.max()[i] + 1e-9);
+                    }
+                }
+            });
+        });
+    }
+}
+
+TEST_CASE("minkowski sum pattern parts")
+{
+    const auto contour = Polytope::loadObj("examples/tetrahedron_4.obj");
+    const auto pattern = Polytope::loadObj("examples/box_12.obj");
+    const MinkowskiSum minkowskiSum(contour, dummyDecomposition(&pattern));
+    REQUIRE(minkowskiSum.contourFacets().size() == 4);
+    REQUIRE(minkowskiSum.patternParts().size() == 1);
+
+    const auto& part = minkowskiSum.patternParts().front();
+    REQUIRE(part.vertices.size() == pattern.vertices().size());
+    const auto& halfspaces = part.halfspaces;
+    for (size_t j = 0; j < halfspaces.size(); ++j) {
+        REQUIRE(halfspaces.offsets0[j] == 0.);
+        // Every plane supports the pattern
+        double support = -std::numeric_limits<double>::infinity();
+        for (const auto& vertex : part.vertices) {
+            double projection = 0.;
+            for (size_t i = 0; i < DIMS; ++i) {
+                projection += halfspaces.normals[i][j] * vertex[i];
+            }
+            support = std::max(support, projection);
+        }
+        REQUIRE(support == Approx(halfspaces.offsetSlopes[j]));
+    }
+}
@@ -0,0 +1,62 @@
+#include "grid/sampling/refinement.h"
+#include "solver/inverse/morphology_ms_rasterizer.h"
+#include "tests/solver/helpers.h"
+
+#include <catch2/catch.hpp>
+
+TEST_CASE("morphology minkowski sum rasterizer")
+{
+    const ExampleSum example("tetra_144", "tetrahedron_4");
+    const VectorSampling<Location> sampling{
+        Box({0., 0.1, 0.05}, 0.6),
+        32,
+        Location::Outer};
+
+    const auto reference = referenceMSRasterizer();
+    const auto morphologyRasterizer = morphologyMSRasterizer(reference);
+
+    const auto compare = [&] (const VectorSampling<Location>& sampling,
+            double scale) {
+        // The reference only rejects a voxel by a single halfspace,
+        // so some voxels near the part edges are boundary for it alone
+        const auto expectedLocations =
+            imageLocations(reference, example.sum, scale, sampling);
+        const auto actualLocations =
+            imageLocations(morphologyRasterizer, example.sum, scale, sampling);
+        REQUIRE(actualLocations.size() == expectedLocations.size());
+        for (size_t i = 0; i < actualLocations.size(); ++i) {
+            if (expectedLocations[i] == Location::Boundary &&
+                    actualLocations[i] == Location::Outer) {
+                continue;
+            }
+            REQUIRE(actualLocations[i] == expectedLocations[i]);
+        }
+    };
+
+    for (double scale : {0.05, 0.3, 0.5, 0.2}) {
+        compare(sampling, scale);
+    }
+
+    // Shrunk samplings reuse the boundary voxels of the grid
+    const auto shrunk = shrunkOutsideImage(example.sum, 0.3, sampling);
+    REQUIRE(alignmentOffset(shrunk, sampling));
+    compare(shrunk, 0.3);
+    compare(shrunk, 0.35);
+
+    // Refined samplings have a grid of their own
+    compare(refine(shrunk), 0.3);
+}
+
+TEST_CASE("morphology minkowski sum rasterizer fallback")
+{
+    const auto example = tetrahedronBoxSum();
+    const auto sampling = tetrahedronBoxSampling(16);
+
+    const auto reference = referenceMSRasterizer();
+    // Any box is too large
+    const auto morphologyRasterizer = morphologyMSRasterizer(reference, 0);
+
+    REQUIRE(
+        imageLocations(morphologyRasterizer, example.sum, 0.3, sampling) ==
+        imageLocations(reference, example.sum, 0.3, sampling));
+}
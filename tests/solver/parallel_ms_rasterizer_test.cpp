@@ -0,0 +1,63 @@
+#include "geometry/entity/bounding_box.h"
+#include "grid/sampling/location_planes.h"
+#include "tests/solver/helpers.h"
+
+#include <catch2/catch.hpp>
+
+#include <algorithm>
+
+TEST_CASE("parallel minkowski sum rasterizer")
+{
+    const ExampleSum example("heart_320", "box_12");
+    const auto sampling = polytopeSampling(example.contour, 24);
+    // Images of a few voxels scattered over the box are reduced sparsely
+    const auto sparse = sparseSampling(
+        sampling,
+        [] (const Coordinates& coordinates) {
+            return coordinates[0] % 3 == 0 &&
+                coordinates[1] % 3 == 0 &&
+                coordinates[2] % 3 == 0;
+        });
+    REQUIRE(LocationPlanes::preferableBox(sampling));
+    REQUIRE(!LocationPlanes::preferableBox(sparse));
+
+    // The sum covers the whole container at a large scale
+    const Box container = boundingBox(example.contour.vertices());
+    const VectorSampling<Location> covered{
+        {container.center(), container.radius() * 0.1},
+        8,
+        Location::Outer};
+    const double coveringScale = container.radius() * 4.;
+
+    const auto reference = referenceMSRasterizer();
+
+    for (size_t workersCount : {1, 2, 3, 8}) {
+        const auto parallelRasterizer = parallelDecomposingMSRasterizer(
+            rasterizePartByHalfspaces, workersCount);
+
+        // The same rasterizer is run again and again
+        for (const auto* testSampling : {&sampling, &sparse, &sampling}) {
+            for (double scale : {0.2, 0.4}) {
+                const auto expectedLocations = imageLocations(
+                    reference, example.sum, scale, *testSampling);
+                REQUIRE(imageLocations(
+                    parallelRasterizer, example.sum, scale, *testSampling) ==
+                    expectedLocations);
+                REQUIRE(std::count(
+                    expectedLocations.begin(), expectedLocations.end(),
+                    Location::Inner) > 0);
+            }
+        }
+
+        // Parts left are skipped once an image is inner everywhere
+        const auto coveredLocations = imageLocations(
+            parallelRasterizer, example.sum, coveringScale, covered);
+        REQUIRE(std::all_of(
+            coveredLocations.begin(), coveredLocations.end(),
+            [] (Location location) {
+                return location == Location::Inner;
+            }));
+        REQUIRE(coveredLocations == imageLocations(
+            reference, example.sum, coveringScale, covered));
+    }
+}
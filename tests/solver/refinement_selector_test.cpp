@@ -0,0 +1,53 @@
+#include "geometry/location/location.h"
+#include "grid/sampling/refinement.h"
+#include "grid/sampling/vector_sampling.h"
+#include "solver/inverse/accuracy_estimator.h"
+
+#include <catch2/catch.hpp>
+
+#include <vector>
+
+namespace {
+
+VectorSampling<Location> selection(const std::vector<Coordinates>& voxels)
+{
+    return {
+        Mapper{Box{{0., 0., 0.}, 1.}, 4},
+        VectorSparseRaster<Location>::fromSorted(voxels, Location::Boundary)
+    };
+}
+
+} // namespace
+
+TEST_CASE("refinement selector")
+{
+    const std::vector<Coordinates> voxels{{0, 0, 1}, {1, 2, 3}, {3, 3, 0}};
+    auto sampling = selection(voxels);
+    auto probe = selection(voxels);
+    probe.find(Coordinates({0, 0, 1}))->value = Location::Outer;
+
+    RefinementSelector selector(0.1);
+
+    // Coarse steps refine every voxel
+    selector.select(1., 0.2, probe, &sampling);
+    REQUIRE(selector.accuracy(1., 0.3) == Approx(0.3));
+    REQUIRE(refine(sampling).size() == voxels.size() * 8);
+
+    // Empty voxels are left out once the step is fine enough,
+    // they bound the accuracy by the probed radius
+    selector.select(1., 0.05, probe, &sampling);
+    REQUIRE(sampling.find(Coordinates({0, 0, 1}))->value == Location::Outer);
+    REQUIRE(sampling.find(Coordinates({1, 2, 3}))->value ==
+        Location::Boundary);
+    REQUIRE(refine(sampling).size() == (voxels.size() - 1) * 8);
+    REQUIRE(selector.accuracy(1., 0.01) == Approx(0.05));
+    REQUIRE(selector.accuracy(1., 0.07) == Approx(0.07));
+
+    // Nothing left to refine, the left out voxels bound the accuracy
+    for (auto& coordinates : voxels) {
+        probe.find(coordinates)->value = Location::Outer;
+    }
+    selector.select(1.02, 0.025, probe, &sampling);
+    REQUIRE(refine(sampling).size() == 0);
+    REQUIRE(selector.accuracy(1.02, 0.5) == Approx(0.03));
+}
@@ -0,0 +1,32 @@
+#include "grid/sampling/refinement.h"
+#include "solver/inverse/scale_interval_rasterizer.h"
+#include "tests/solver/helpers.h"
+
+#include <catch2/catch.hpp>
+
+TEST_CASE("scale interval rasterizer")
+{
+    const auto example = tetrahedronBoxSum();
+    const auto sampling = tetrahedronBoxSampling(16);
+
+    const auto reference = referenceMSRasterizer();
+    const auto intervalRasterizer = scaleIntervalMSRasterizer(4.);
+
+    const auto compare = [&] (const VectorSampling<Location>& sampling,
+            double scale) {
+        REQUIRE(
+            imageLocations(intervalRasterizer, example.sum, scale, sampling) ==
+            imageLocations(reference, example.sum, scale, sampling));
+    };
+
+    // Within a window, past it and back again
+    for (double scale : {0.2, 0.25, 0.4, 0.6, 1.5, 0.3}) {
+        compare(sampling, scale);
+    }
+
+    // Shrunk samplings are aligned with the cached grid
+    const auto shrunk = shrunkOutsideImage(example.sum, 0.3, sampling);
+    REQUIRE(alignmentOffset(shrunk, sampling));
+    compare(shrunk, 0.3);
+    compare(shrunk, 0.35);
+}
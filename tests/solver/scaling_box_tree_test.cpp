@@ -0,0 +1,62 @@
+#include "solver/inverse/scaling_box_tree.h"
+
+#include <catch2/catch.hpp>
+
+#include <random>
+#include <vector>
+
+TEST_CASE("scaling box tree")
+{
+    std::mt19937 random(13);
+    std::uniform_real_distribution<double> coordinate(-10., 10.);
+    std::uniform_real_distribution<double> extent(0., 2.);
+
+    const auto randomPoint = [&] {
+        return Point{
+            coordinate(random), coordinate(random), coordinate(random)};
+    };
+    const auto randomExtent = [&] {
+        return Vector<>{extent(random), extent(random), extent(random)};
+    };
+
+    std::vector<ScalingBox> boxes;
+    for (size_t i = 0; i < 200; ++i) {
+        const auto origin = randomPoint();
+        const Vector<> direction = randomPoint() / 10.;
+        boxes.push_back({
+            origin,
+            (origin + randomExtent()).eval(),
+            direction,
+            (direction + randomExtent()).eval()
+        });
+    }
+    const ScalingBoxTree tree(boxes);
+
+    for (size_t i = 0; i < 50; ++i) {
+        const auto center = randomPoint();
+        const auto radius = randomExtent();
+        const BoundingBox region{
+            (center - radius).eval(),
+            (center + radius).eval()};
+        const double minScale = extent(random);
+        const double maxScale = minScale + (i % 2 == 0 ? 0. : extent(random));
+
+        std::vector<size_t> expected;
+        for (size_t j = 0; j < boxes.size(); ++j) {
+            if (boxes[j].intersects(region, minScale, maxScale)) {
+                expected.push_back(j);
+            }
+        }
+        REQUIRE(tree.intersecting(region, minScale, maxScale) == expected);
+    }
+
+    // Bounds move with the scale
+    const ScalingBox box{
+        Point::constant(0.), Point::constant(1.),
+        Vector<>::Constant(1.), Vector<>::Constant(1.)};
+    const BoundingBox region{Point::constant(4.), Point::constant(5.)};
+    REQUIRE(!box.intersects(region, 1., 2.));
+    REQUIRE(box.intersects(region, 1., 3.));
+    REQUIRE(box.intersects(region, 4.5, 4.5));
+    REQUIRE(!box.intersects(region, 6., 7.));
+}
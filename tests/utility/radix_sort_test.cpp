@@ -0,0 +1,27 @@
+#include "utility/radix_sort.h"
+
+#include <catch2/catch.hpp>
+
+#include <algorithm>
+#include <random>
+
+TEST_CASE("radix sort")
+{
+    std::mt19937_64 random(7);
+
+    for (const uint64_t mask : {~uint64_t{0}, uint64_t{0xFFF}, uint64_t{0}}) {
+        std::vector<uint64_t> keys(1000);
+        for (auto& key : keys) {
+            key = (random() & mask) | (uint64_t{5} << 50);
+        }
+        auto expected = keys;
+        std::sort(expected.begin(), expected.end());
+
+        radixSort(&keys);
+        REQUIRE(keys == expected);
+    }
+
+    std::vector<uint64_t> empty;
+    radixSort(&empty);
+    REQUIRE(empty.empty());
+}
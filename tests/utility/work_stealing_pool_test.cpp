@@ -0,0 +1,89 @@
+#include "utility/work_stealing_pool.h"
+
+#include <catch2/catch.hpp>
+
+#include <atomic>
+#include <chrono>
+#include <mutex>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+TEST_CASE("work stealing pool runs every task once")
+{
+    for (size_t workersCount : {1, 2, 3, 8}) {
+        WorkStealingPool pool(workersCount);
+        REQUIRE(pool.workersCount() == workersCount);
+
+        for (size_t tasksCount : {0, 1, 5, 1000}) {
+            std::vector<std::atomic<int>> runs(tasksCount);
+            std::atomic<int> totalRuns{0};
+            std::atomic<bool> workersValid{true};
+            // Catch assertions are not thread-safe, so we just record here
+            pool.run(tasksCount, [&] (size_t workerIndex, size_t taskIndex) {
+                if (workerIndex >= workersCount) {
+                    workersValid = false;
+                }
+                ++runs[taskIndex];
+                ++totalRuns;
+            });
+
+            REQUIRE(workersValid);
+
+            for (const auto& taskRuns : runs) {
+                REQUIRE(taskRuns == 1);
+            }
+            REQUIRE(totalRuns == static_cast<int>(tasksCount));
+        }
+    }
+}
+
+TEST_CASE("work stealing pool rethrows task exceptions")
+{
+    WorkStealingPool pool(4);
+    std::atomic<int> runs{0};
+    REQUIRE_THROWS_AS(
+        pool.run(100, [&] (size_t /*workerIndex*/, size_t taskIndex) {
+            ++runs;
+            if (taskIndex == 42) {
+                throw std::runtime_error("task failure");
+            }
+        }),
+        std::runtime_error);
+    REQUIRE(runs > 0);
+    REQUIRE(runs <= 100);
+}
+
+TEST_CASE("work stealing pool keeps its threads")
+{
+    WorkStealingPool pool(4);
+
+    // Thread of every worker index, the batches are to match
+    const auto workerThreads = [&pool] (size_t tasksCount) {
+        std::vector<std::thread::id> result(pool.workersCount());
+        std::mutex mutex;
+        pool.run(tasksCount, [&] (size_t workerIndex, size_t /*taskIndex*/) {
+            // Keeps every worker busy long enough to take a task
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+            std::lock_guard<std::mutex> lock(mutex);
+            result[workerIndex] = std::this_thread::get_id();
+        });
+        return result;
+    };
+
+    const auto first = workerThreads(100);
+    REQUIRE(first[0] == std::this_thread::get_id());
+    for (size_t run = 0; run < 3; ++run) {
+        const auto next = workerThreads(100);
+        for (size_t worker = 0; worker < pool.workersCount(); ++worker) {
+            if (next[worker] != std::thread::id{} &&
+                    first[worker] != std::thread::id{}) {
+                REQUIRE(next[worker] == first[worker]);
+            }
+        }
+    }
+
+    // Batches of fewer tasks than workers leave the rest waiting
+    REQUIRE(workerThreads(2)[0] == std::this_thread::get_id());
+    REQUIRE(workerThreads(1)[0] == std::this_thread::get_id());
+}